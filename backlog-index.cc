@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "backlog-index.h"
+#include <algorithm>
+
+namespace ns3 {
+
+const uint16_t BacklogIndex::NONE;
+
+BacklogIndex::BacklogIndex ()
+{
+}
+
+void
+BacklogIndex::Grow (uint16_t aid)
+{
+  if (aid < m_tids.size ())
+    {
+      return;
+    }
+  std::size_t size = aid + 1;
+  m_stations.resize ((size + 63) / 64, 0);
+  m_tids.resize (size, 0);
+  m_mpdus.resize (size * 8, 0);
+  m_bytes.resize (size * 8, 0);
+}
+
+void
+BacklogIndex::NotifyEnqueue (uint16_t aid, uint8_t tid, uint32_t bytes)
+{
+  Grow (aid);
+  m_mpdus[aid * 8 + (tid & 0x07)]++;
+  m_bytes[aid * 8 + (tid & 0x07)] += bytes;
+  m_tids[aid] |= (1 << (tid & 0x07));
+  m_stations[aid / 64] |= (uint64_t (1) << (aid % 64));
+}
+
+void
+BacklogIndex::NotifyDequeue (uint16_t aid, uint8_t tid, uint32_t bytes)
+{
+  if (aid >= m_tids.size ())
+    {
+      return;
+    }
+  uint32_t& mpdus = m_mpdus[aid * 8 + (tid & 0x07)];
+  uint32_t& queuedBytes = m_bytes[aid * 8 + (tid & 0x07)];
+  // frames queued before the station associated are not counted
+  queuedBytes -= std::min (queuedBytes, bytes);
+  if (mpdus > 0 && --mpdus == 0)
+    {
+      Clear (aid, tid);
+    }
+}
+
+void
+BacklogIndex::Clear (uint16_t aid, uint8_t tid)
+{
+  if (aid >= m_tids.size ())
+    {
+      return;
+    }
+  m_mpdus[aid * 8 + (tid & 0x07)] = 0;
+  m_bytes[aid * 8 + (tid & 0x07)] = 0;
+  m_tids[aid] &= ~(1 << (tid & 0x07));
+  if (m_tids[aid] == 0)
+    {
+      m_stations[aid / 64] &= ~(uint64_t (1) << (aid % 64));
+    }
+}
+
+void
+BacklogIndex::Clear (uint16_t aid)
+{
+  for (uint8_t tid = 0; tid < 8; tid++)
+    {
+      Clear (aid, tid);
+    }
+}
+
+uint16_t
+BacklogIndex::GetNext (uint32_t aid) const
+{
+  std::size_t word = aid / 64;
+  if (word >= m_stations.size ())
+    {
+      return NONE;
+    }
+  uint64_t bits = m_stations[word] & (~uint64_t (0) << (aid % 64));
+  while (bits == 0)
+    {
+      if (++word == m_stations.size ())
+        {
+          return NONE;
+        }
+      bits = m_stations[word];
+    }
+  return static_cast<uint16_t> (word * 64 + __builtin_ctzll (bits));
+}
+
+} //namespace ns3
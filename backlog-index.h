@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BACKLOG_INDEX_H
+#define BACKLOG_INDEX_H
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * BacklogIndex keeps track of the (station, TID) pairs the AP has frames to
+ * send to, so that a scheduling pass only visits the backlogged stations
+ * rather than all the associated stations. It is updated upon every enqueue
+ * and dequeue (or expiration) of a frame and holds, for every AID, the number
+ * of queued MPDUs and bytes of each TID and the bitmask of the backlogged
+ * TIDs, and a bitset of the backlogged AIDs, which is scanned one 64-bit word
+ * at a time. The backlog of a (station, TID) pair is read in constant time,
+ * e.g., to size the RU of the station on the whole backlog.
+ *
+ * Frames may leave the queues without being notified (e.g., when removed by
+ * the MAC), hence a (station, TID) pair may be marked backlogged while no
+ * frame is queued. The scheduler clears such pairs when it finds no frame to
+ * send (lazy clearing). Conversely, a pair with queued frames is always marked
+ * backlogged.
+ */
+class BacklogIndex
+{
+public:
+  static const uint16_t NONE = 0xffff;      //!< returned by GetNext if there is no backlogged station
+
+  BacklogIndex ();
+
+  /**
+   * Notify that an MPDU of the given TID has been queued for the given station.
+   *
+   * \param aid the AID of the station
+   * \param tid the TID
+   * \param bytes the size of the MPDU
+   */
+  void NotifyEnqueue (uint16_t aid, uint8_t tid, uint32_t bytes);
+  /**
+   * Notify that an MPDU of the given TID for the given station has left the queue.
+   *
+   * \param aid the AID of the station
+   * \param tid the TID
+   * \param bytes the size of the MPDU
+   */
+  void NotifyDequeue (uint16_t aid, uint8_t tid, uint32_t bytes);
+  /**
+   * Mark the given (station, TID) pair as not backlogged.
+   *
+   * \param aid the AID of the station
+   * \param tid the TID
+   */
+  void Clear (uint16_t aid, uint8_t tid);
+  /**
+   * Mark all the TIDs of the given station as not backlogged.
+   *
+   * \param aid the AID of the station
+   */
+  void Clear (uint16_t aid);
+
+  /**
+   * \param aid an AID
+   * \return the smallest AID not lower than the given one of a backlogged
+   *         station, or NONE
+   */
+  uint16_t GetNext (uint32_t aid) const;
+  /**
+   * \param aid the AID of a station
+   * \return the bitmask of the backlogged TIDs of the station
+   */
+  uint8_t GetTids (uint16_t aid) const
+  {
+    return (aid < m_tids.size () ? m_tids[aid] : 0);
+  }
+  /**
+   * \param aid the AID of a station
+   * \param tid the TID
+   * \return the number of MPDUs of the given TID queued for the station
+   */
+  uint32_t GetMpdus (uint16_t aid, uint8_t tid) const
+  {
+    return (aid < m_tids.size () ? m_mpdus[aid * 8 + (tid & 0x07)] : 0);
+  }
+  /**
+   * \param aid the AID of a station
+   * \param tid the TID
+   * \return the bytes of the MPDUs of the given TID queued for the station
+   */
+  uint32_t GetBytes (uint16_t aid, uint8_t tid) const
+  {
+    return (aid < m_tids.size () ? m_bytes[aid * 8 + (tid & 0x07)] : 0);
+  }
+
+private:
+  /**
+   * Make room for the given AID.
+   *
+   * \param aid the AID
+   */
+  void Grow (uint16_t aid);
+
+  std::vector<uint64_t> m_stations;     //!< bitset of the backlogged AIDs
+  std::vector<uint8_t> m_tids;          //!< bitmask of the backlogged TIDs, indexed by AID
+  std::vector<uint32_t> m_mpdus;        //!< queued MPDUs, indexed by AID * 8 + TID
+  std::vector<uint32_t> m_bytes;        //!< queued bytes, indexed by AID * 8 + TID
+};
+
+} //namespace ns3
+
+#endif /* BACKLOG_INDEX_H */
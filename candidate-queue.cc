@@ -0,0 +1,275 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "candidate-queue.h"
+#include "he-rate-table.h"
+#include "scheduling-policy.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace ns3 {
+
+namespace {
+
+/**
+ * Keep the k largest values in a min-heap.
+ *
+ * \param heap the min-heap
+ * \param value the value to add
+ * \param k the number of values kept
+ */
+template <class T>
+void
+KeepLargest (std::vector<T>& heap, T value, std::size_t k)
+{
+  heap.push_back (value);
+  std::push_heap (heap.begin (), heap.end (), std::greater<T> ());
+  if (heap.size () > k)
+    {
+      std::pop_heap (heap.begin (), heap.end (), std::greater<T> ());
+      heap.pop_back ();
+    }
+}
+
+} // unnamed namespace
+
+const uint16_t CandidateQueue::NONE;
+const std::size_t CandidateQueue::N_BUCKETS;
+
+CandidateQueue::CandidateQueue ()
+  : m_size (0),
+    m_entries (0),
+    m_horizon (20000000),
+    m_growth (1.0),
+    m_deadline (std::numeric_limits<int64_t>::min ()),
+    m_fixedPoint (false),
+    m_maxRate (HeRateTable::GetRateKbps (HeRateTable::N_MCS - 1, 160, 800,
+                                         HeRateTable::GetRuIndex (HeRateTable::GetFullBandRuTones (160))) / 1e3),
+    m_maxUsers (0),
+    m_largest (0)
+{
+}
+
+void
+CandidateQueue::SetHorizon (int64_t horizon, double growth)
+{
+  NS_ASSERT (horizon > 0 && growth >= 1.0);
+  m_horizon = horizon;
+  m_growth = growth;
+}
+
+void
+CandidateQueue::SetWeights (bool fixedPoint, double maxRate)
+{
+  NS_ASSERT (maxRate > 0);
+  m_fixedPoint = fixedPoint;
+  m_maxRate = maxRate;
+}
+
+void
+CandidateQueue::Reset (int64_t now)
+{
+  for (auto& bucket : m_buckets)
+    {
+      bucket.clear ();
+    }
+  std::fill (m_queued.begin (), m_queued.end (), 0);
+  m_size = 0;
+  m_entries = 0;
+  m_deadline = now + m_horizon;
+}
+
+bool
+CandidateQueue::NeedsRebuild (int64_t now) const
+{
+  return now >= m_deadline;
+}
+
+void
+CandidateQueue::Grow (uint16_t aid)
+{
+  if (aid >= m_version.size ())
+    {
+      m_version.resize (aid + 1, 0);
+      m_queued.resize (aid + 1, 0);
+    }
+}
+
+void
+CandidateQueue::Insert (uint8_t bucket, uint16_t aid, double bound)
+{
+  Grow (aid);
+  if (m_queued[aid] == 0)
+    {
+      m_queued[aid] = 1;
+      m_size++;
+    }
+  m_version[aid]++;
+  m_buckets[bucket].push_back ({bound, aid, m_version[aid]});
+  std::push_heap (m_buckets[bucket].begin (), m_buckets[bucket].end ());
+  m_entries++;
+
+  // compact the heaps once most of their entries are stale
+  if (m_entries > 2 * m_size + 64)
+    {
+      m_entries = 0;
+      for (auto& heap : m_buckets)
+        {
+          heap.erase (std::remove_if (heap.begin (), heap.end (),
+                                      [this] (const Entry& entry) { return !IsCurrent (entry); }),
+                      heap.end ());
+          std::make_heap (heap.begin (), heap.end ());
+          m_entries += heap.size ();
+        }
+    }
+}
+
+double
+CandidateQueue::GetBound (uint8_t trafficClass, int64_t holTimestamp, double avgThroughput) const
+{
+  // the weight at the rebuild deadline, with the largest rate and the served
+  // throughput decayed as much as it can be until then
+  double holDelay = StaStateTable::GetHolDelay (m_deadline, holTimestamp);
+  if (m_fixedPoint)
+    {
+      // rounded up, so that the bound is not below the integer weight
+      return std::nextafter (static_cast<double> (FixedPointMlwdfPolicy::FixedWeight (trafficClass, holDelay, m_maxRate,
+                                                                                     avgThroughput / m_growth)),
+                             std::numeric_limits<double>::infinity ());
+    }
+  return MlwdfPolicy ().DoWeight (trafficClass, holDelay, m_maxRate, avgThroughput / m_growth, 0);
+}
+
+void
+CandidateQueue::Push (uint16_t aid, uint8_t trafficClass, double bound)
+{
+  NS_ASSERT (trafficClass > TrafficClassifier::UNKNOWN && trafficClass < N_BUCKETS);
+  Insert (trafficClass, aid, bound);
+}
+
+void
+CandidateQueue::Invalidate (uint16_t aid)
+{
+  Insert (TrafficClassifier::UNKNOWN, aid, std::numeric_limits<double>::infinity ());
+}
+
+void
+CandidateQueue::Remove (uint16_t aid)
+{
+  if (IsQueued (aid))
+    {
+      m_queued[aid] = 0;
+      m_size--;
+    }
+}
+
+std::size_t
+CandidateQueue::CleanTops (void)
+{
+  std::size_t best = N_BUCKETS;
+  for (std::size_t b = 0; b < N_BUCKETS; b++)
+    {
+      std::vector<Entry>& heap = m_buckets[b];
+      while (!heap.empty () && !IsCurrent (heap.front ()))
+        {
+          std::pop_heap (heap.begin (), heap.end ());
+          heap.pop_back ();
+          m_entries--;
+        }
+      if (!heap.empty () && (best == N_BUCKETS || m_buckets[best].front () < heap.front ()))
+        {
+          best = b;
+        }
+    }
+  return best;
+}
+
+double
+CandidateQueue::GetMaxBound (void)
+{
+  std::size_t best = CleanTops ();
+  return (best < N_BUCKETS ? m_buckets[best].front ().bound : -1.0);
+}
+
+uint16_t
+CandidateQueue::Pop (void)
+{
+  std::size_t best = CleanTops ();
+  if (best == N_BUCKETS)
+    {
+      return NONE;
+    }
+  std::vector<Entry>& heap = m_buckets[best];
+  uint16_t aid = heap.front ().aid;
+  std::pop_heap (heap.begin (), heap.end ());
+  heap.pop_back ();
+  m_entries--;
+  m_queued[aid] = 0;
+  m_size--;
+  return aid;
+}
+
+void
+CandidateQueue::StartSelection (std::size_t maxUsers)
+{
+  NS_ASSERT (maxUsers > 0);
+  m_maxUsers = maxUsers;
+  m_topWeights.clear ();
+  m_topFixedWeights.clear ();
+  m_largest = 0;
+}
+
+void
+CandidateQueue::AddSelected (uint8_t trafficClass, double holDelay, double rate, double avgThroughput)
+{
+  if (m_fixedPoint)
+    {
+      uint64_t weight = FixedPointMlwdfPolicy::FixedWeight (trafficClass, holDelay, rate, avgThroughput);
+      m_largest = std::max (m_largest, weight);
+      KeepLargest (m_topFixedWeights, weight, m_maxUsers);
+    }
+  else
+    {
+      KeepLargest (m_topWeights, MlwdfPolicy ().DoWeight (trafficClass, holDelay, rate, avgThroughput, 0),
+                   m_maxUsers);
+    }
+}
+
+bool
+CandidateQueue::IsSelectionDone (void)
+{
+  if (m_size == 0)
+    {
+      return true;
+    }
+  if ((m_fixedPoint ? m_topFixedWeights.size () : m_topWeights.size ()) < m_maxUsers)
+    {
+      return false;
+    }
+  double bound = GetMaxBound ();
+  if (m_fixedPoint)
+    {
+      unsigned shift = FixedPointMlwdfPolicy::GetShift (m_largest);
+      double normalizedBound = std::max (std::floor (std::ldexp (bound, -static_cast<int> (shift))), 1.0);
+      return normalizedBound < FixedPointMlwdfPolicy::Normalize (m_topFixedWeights.front (), shift);
+    }
+  return bound < m_topWeights.front ();
+}
+
+} //namespace ns3
@@ -0,0 +1,261 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CANDIDATE_QUEUE_H
+#define CANDIDATE_QUEUE_H
+
+#include "traffic-classifier.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * CandidateQueue orders the backlogged stations by an upper bound to their
+ * M-LWDF weight, so that a scheduling pass can examine the stations by
+ * decreasing bound and stop as soon as no remaining station can outweigh the
+ * candidates found, rather than examining all the backlogged stations.
+ *
+ * The weight a_i W_i r_i / R_i of a station grows with its head-of-line delay
+ * W_i and, while it is not served, as its served throughput R_i decays. The
+ * bound of a frame queued for a station (see GetBound) is the weight the
+ * station would have at the rebuild deadline if that frame were its
+ * head-of-line frame, with the largest rate r_i and R_i divided by the growth
+ * factor. Since the TID the station is served for depends on the TXOP, the
+ * bound of a station is the largest bound of the oldest frames of its
+ * backlogged TIDs. It holds until the deadline, after which the caller must
+ * evaluate all the backlogged stations again and reset the queue. A station
+ * whose bound is unknown (e.g., it just became backlogged for a TID, or a
+ * frame older than its head-of-line frames was queued again) has an infinite
+ * bound until it is evaluated.
+ *
+ * Stations are kept in buckets, one per traffic class (stations that have not
+ * been evaluated are in the bucket of the unknown class), each of which is a
+ * binary max-heap of bounds; the station with the largest bound is found by
+ * comparing the tops of the buckets. Heaps are updated lazily: when a station
+ * is pushed again or removed, its previous entry is left in its heap and
+ * discarded once it reaches the top, and the heaps are compacted when stale
+ * entries outnumber the queued stations.
+ *
+ * A selection (see StartSelection) pops the stations by decreasing bound and
+ * is done once the given number of candidates has been added and no remaining
+ * station can outweigh the lightest of them. In fixed-point mode, the weights
+ * are compared once normalized with the block exponent of the candidates
+ * found (see FixedPointMlwdfPolicy), as equal normalized weights are ranked by
+ * AID.
+ */
+class CandidateQueue
+{
+public:
+  static const uint16_t NONE = 0xffff;      //!< returned by Pop if the queue is empty
+
+  CandidateQueue ();
+
+  /**
+   * Set the time between two rebuilds and the growth of the bounds.
+   *
+   * \param horizon the time (ns) between two rebuilds
+   * \param growth the largest factor by which the served throughput R_i of a
+   *        station can decay within the horizon
+   */
+  void SetHorizon (int64_t horizon, double growth);
+  /**
+   * Set how the weights are computed.
+   *
+   * \param fixedPoint whether the weights are computed by FixedPointMlwdfPolicy
+   *        rather than by MlwdfPolicy
+   * \param maxRate the largest rate (Mb/s) of a station
+   */
+  void SetWeights (bool fixedPoint, double maxRate);
+  /**
+   * Remove all the stations and set the rebuild deadline.
+   *
+   * \param now the current time (ns)
+   */
+  void Reset (int64_t now);
+  /**
+   * \param now the current time (ns)
+   * \return true if the rebuild deadline has passed
+   */
+  bool NeedsRebuild (int64_t now) const;
+  /**
+   * \return the rebuild deadline (ns)
+   */
+  int64_t GetDeadline (void) const
+  {
+    return m_deadline;
+  }
+  /**
+   * \return the largest factor by which the served throughput of a station
+   *         can decay before the rebuild deadline
+   */
+  double GetGrowth (void) const
+  {
+    return m_growth;
+  }
+
+  /**
+   * \param trafficClass the traffic class of a frame queued for a station
+   * \param holTimestamp the timestamp (ns) of the frame
+   * \param avgThroughput the average throughput (Mb/s) currently served to the station
+   * \return the bound to the weight of the station until the rebuild deadline,
+   *         should the frame be its head-of-line frame
+   */
+  double GetBound (uint8_t trafficClass, int64_t holTimestamp, double avgThroughput) const;
+  /**
+   * Queue a station that has been evaluated, replacing its previous entry.
+   *
+   * \param aid the AID of the station
+   * \param trafficClass the traffic class giving the bound
+   * \param bound the largest bound of the oldest frames of the backlogged TIDs
+   *        of the station
+   */
+  void Push (uint16_t aid, uint8_t trafficClass, double bound);
+  /**
+   * Queue a station with an infinite bound, replacing its previous entry, so
+   * that it is evaluated at the next selection.
+   *
+   * \param aid the AID of the station
+   */
+  void Invalidate (uint16_t aid);
+  /**
+   * Remove a station from the queue.
+   *
+   * \param aid the AID of the station
+   */
+  void Remove (uint16_t aid);
+  /**
+   * \param aid the AID of a station
+   * \return true if the station is queued
+   */
+  bool IsQueued (uint16_t aid) const
+  {
+    return aid < m_version.size () && m_queued[aid] != 0;
+  }
+  /**
+   * \return the number of queued stations
+   */
+  std::size_t GetSize (void) const
+  {
+    return m_size;
+  }
+
+  /**
+   * \return the largest bound of the queued stations, or a negative value if
+   *         the queue is empty
+   */
+  double GetMaxBound (void);
+  /**
+   * Remove the station with the largest bound from the queue.
+   *
+   * \return the AID of the station, or NONE if the queue is empty
+   */
+  uint16_t Pop (void);
+
+  /**
+   * Start a selection.
+   *
+   * \param maxUsers the number of candidates to select
+   */
+  void StartSelection (std::size_t maxUsers);
+  /**
+   * Add a popped station to the candidates of the selection.
+   *
+   * \param trafficClass the traffic class of the station
+   * \param holDelay the head-of-line delay (s) of the station
+   * \param rate the rate (Mb/s) of the MCS of the station
+   * \param avgThroughput the average throughput (Mb/s) served to the station
+   */
+  void AddSelected (uint8_t trafficClass, double holDelay, double rate, double avgThroughput);
+  /**
+   * \return true if the queue is empty or if enough candidates have been added
+   *         and no queued station can outweigh the lightest of them
+   */
+  bool IsSelectionDone (void);
+
+private:
+  /// An entry of a heap
+  struct Entry
+  {
+    double bound;       //!< the bound of the station
+    uint16_t aid;       //!< the AID of the station
+    uint32_t version;   //!< the version of the station when the entry was pushed
+
+    /**
+     * \param other another entry
+     * \return true if this entry has a lower bound than the other one
+     */
+    bool operator< (const Entry& other) const
+    {
+      return bound < other.bound || (bound == other.bound && aid > other.aid);
+    }
+  };
+
+  /**
+   * Make room for the given AID.
+   *
+   * \param aid the AID
+   */
+  void Grow (uint16_t aid);
+  /**
+   * Push an entry in the given bucket and invalidate the previous entry of the station.
+   *
+   * \param bucket the bucket
+   * \param aid the AID of the station
+   * \param bound the bound of the station
+   */
+  void Insert (uint8_t bucket, uint16_t aid, double bound);
+  /**
+   * Discard the stale entries at the top of the heaps.
+   *
+   * \return the bucket whose top has the largest bound, or N_BUCKETS if all are empty
+   */
+  std::size_t CleanTops (void);
+  /**
+   * \param entry an entry of a heap
+   * \return true if the entry is the current entry of its station
+   */
+  bool IsCurrent (const Entry& entry) const
+  {
+    return m_queued[entry.aid] != 0 && m_version[entry.aid] == entry.version;
+  }
+
+  /// the number of buckets: one per traffic class and one for the unknown class
+  static const std::size_t N_BUCKETS = TrafficClassifier::N_CLASSES + 1;
+
+  std::array<std::vector<Entry>, N_BUCKETS> m_buckets;  //!< the heaps, indexed by traffic class
+  std::vector<uint32_t> m_version;      //!< the version of the current entry, indexed by AID
+  std::vector<uint8_t> m_queued;        //!< whether each station is queued, indexed by AID
+  std::size_t m_size;                   //!< the number of queued stations
+  std::size_t m_entries;                //!< the number of entries in the heaps
+  int64_t m_horizon;                    //!< the time between two rebuilds (ns)
+  double m_growth;                      //!< the growth of the bounds within the horizon
+  int64_t m_deadline;                   //!< the rebuild deadline (ns)
+  bool m_fixedPoint;                    //!< whether the weights are computed in fixed point
+  double m_maxRate;                     //!< the largest rate (Mb/s) of a station
+  std::size_t m_maxUsers;               //!< the number of candidates to select
+  std::vector<double> m_topWeights;     //!< min-heap of the largest candidate weights
+  std::vector<uint64_t> m_topFixedWeights;  //!< min-heap of the largest fixed-point weights
+  uint64_t m_largest;                   //!< the largest fixed-point weight of the candidates
+};
+
+} //namespace ns3
+
+#endif /* CANDIDATE_QUEUE_H */
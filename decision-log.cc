@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "decision-log.h"
+#include <algorithm>
+
+namespace ns3 {
+
+DecisionLog::DecisionLog ()
+  : m_nUsers (0),
+    m_last (0),
+    m_size (0)
+{
+}
+
+void
+DecisionLog::SetCapacity (std::size_t nDecisions, std::size_t nUsers)
+{
+  m_decisions.assign (nDecisions, Decision ());
+  m_users.assign (nDecisions * nUsers, User ());
+  m_nUsers = nUsers;
+  m_last = nDecisions - 1;
+  m_size = 0;
+}
+
+std::size_t
+DecisionLog::GetSize (void) const
+{
+  return m_size;
+}
+
+void
+DecisionLog::AddDecision (int64_t timestamp, std::size_t nCandidates,
+                          const HeRuTiling::Composition& composition, uint64_t airtime)
+{
+  NS_ASSERT (IsEnabled ());
+  m_last = (m_last + 1) % m_decisions.size ();
+  m_size = std::min (m_size + 1, m_decisions.size ());
+
+  Decision& decision = m_decisions[m_last];
+  decision.timestamp = timestamp;
+  decision.airtime = airtime;
+  decision.composition = composition;
+  decision.nCandidates = static_cast<uint16_t> (nCandidates);
+  decision.nUsers = 0;
+}
+
+bool
+DecisionLog::AddUser (const User& user)
+{
+  NS_ASSERT (m_size > 0);
+  Decision& decision = m_decisions[m_last];
+  if (decision.nUsers == m_nUsers)
+    {
+      return false;
+    }
+  m_users[m_last * m_nUsers + decision.nUsers++] = user;
+  return true;
+}
+
+void
+DecisionLog::Dump (std::ostream& os) const
+{
+  std::size_t first = (m_last + m_decisions.size () + 1 - m_size) % std::max<std::size_t> (m_decisions.size (), 1);
+
+  for (std::size_t k = 0; k < m_size; k++)
+    {
+      std::size_t d = (first + k) % m_decisions.size ();
+      const Decision& decision = m_decisions[d];
+
+      os << "+" << decision.timestamp << "ns candidates=" << decision.nCandidates << " pattern=";
+      bool none = true;
+      for (uint8_t size = HeRateTable::N_RU_SIZES; size-- > 0; )
+        {
+          if (decision.composition[size] > 0)
+            {
+              os << (none ? "" : ",") << +decision.composition[size] << "x" << HeRateTable::GetRuTones (size);
+              none = false;
+            }
+        }
+      os << (none ? "none" : "") << " airtime=" << decision.airtime << "ns" << std::endl;
+
+      for (std::size_t u = 0; u < decision.nUsers; u++)
+        {
+          const User& user = m_users[d * m_nUsers + u];
+          os << "  AID=" << user.aid << " weight=" << user.weight << " MCS=" << +user.mcs;
+          if (user.granted)
+            {
+              os << " RU=" << user.ru;
+              if (user.powerOffset != 0)
+                {
+                  os << " power=" << std::showpos << user.powerOffset << std::noshowpos << "dB";
+                }
+            }
+          os << std::endl;
+        }
+    }
+}
+
+} //namespace ns3
@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DECISION_LOG_H
+#define DECISION_LOG_H
+
+#include "he-ru-tiling.h"
+#include <ostream>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * DecisionLog keeps the most recent scheduling decisions in a ring buffer
+ * whose memory is allocated once, when the capacity is set: every decision
+ * has a fixed number of station slots and the oldest decision is overwritten
+ * when the buffer is full. A decision records the number of candidate
+ * stations, the selected tiling (RU pattern), the predicted duration of the
+ * Data field and, for each recorded station, its weight, MCS, granted RU and
+ * the power offset of the RU.
+ * The buffer can be dumped as text at any time, e.g., to investigate a
+ * throughput regression after the simulation.
+ */
+class DecisionLog
+{
+public:
+  /// A station recorded in a decision
+  struct User
+  {
+    double weight;          //!< the weight of the station
+    HeRu::RuSpec ru;        //!< the granted RU (if any)
+    uint16_t aid;           //!< the AID of the station
+    uint8_t mcs;            //!< the MCS of the station
+    bool granted;           //!< whether the station was granted an RU
+    double powerOffset;     //!< the TX power offset (dB) of the RU from a uniform PSD
+  };
+
+  /// A scheduling decision
+  struct Decision
+  {
+    int64_t timestamp;                    //!< the simulation time (ns)
+    uint64_t airtime;                     //!< the predicted Data field duration (ns), 0 if unknown
+    HeRuTiling::Composition composition;  //!< the selected tiling, all zeros if none
+    uint16_t nCandidates;                 //!< the number of candidate stations
+    uint16_t nUsers;                      //!< the number of recorded stations
+  };
+
+  DecisionLog ();
+
+  /**
+   * Allocate the buffer and discard the stored decisions.
+   *
+   * \param nDecisions the number of decisions kept (0 disables the log)
+   * \param nUsers the number of stations recorded per decision
+   */
+  void SetCapacity (std::size_t nDecisions, std::size_t nUsers);
+  /**
+   * \return true if the capacity of the log is not null
+   */
+  bool IsEnabled (void) const
+  {
+    return !m_decisions.empty ();
+  }
+  /**
+   * \return the number of stored decisions
+   */
+  std::size_t GetSize (void) const;
+
+  /**
+   * Start recording a new decision, overwriting the oldest one if the buffer is full.
+   *
+   * \param timestamp the simulation time (ns)
+   * \param nCandidates the number of candidate stations
+   * \param composition the selected tiling, all zeros if none
+   * \param airtime the predicted Data field duration (ns), 0 if unknown
+   */
+  void AddDecision (int64_t timestamp, std::size_t nCandidates,
+                    const HeRuTiling::Composition& composition, uint64_t airtime);
+  /**
+   * Record a station in the last decision, unless all its slots are used.
+   *
+   * \param user the station
+   * \return true if the station has been recorded
+   */
+  bool AddUser (const User& user);
+
+  /**
+   * Print the stored decisions, from the oldest one.
+   *
+   * \param os the output stream
+   */
+  void Dump (std::ostream& os) const;
+
+private:
+  std::vector<Decision> m_decisions;    //!< the ring buffer of decisions
+  std::vector<User> m_users;            //!< the station slots, nUsers per decision
+  std::size_t m_nUsers;                 //!< the number of station slots per decision
+  std::size_t m_last;                   //!< the index of the last decision
+  std::size_t m_size;                   //!< the number of stored decisions
+};
+
+} //namespace ns3
+
+#endif /* DECISION_LOG_H */
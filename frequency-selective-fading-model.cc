@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "ns3/mobility-model.h"
+#include "frequency-selective-fading-model.h"
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FrequencySelectiveFadingModel");
+
+NS_OBJECT_ENSURE_REGISTERED (FrequencySelectiveFadingModel);
+
+TypeId
+FrequencySelectiveFadingModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FrequencySelectiveFadingModel")
+    .SetParent<SpectrumPropagationLossModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<FrequencySelectiveFadingModel> ()
+    .AddAttribute ("CoherenceBandwidth",
+                   "The bandwidth (Hz) over which the gain of the channel is constant.",
+                   DoubleValue (5e6),
+                   MakeDoubleAccessor (&FrequencySelectiveFadingModel::m_coherenceBandwidth),
+                   MakeDoubleChecker<double> (1e3))
+    .AddAttribute ("CoherenceTime",
+                   "The time after which the gains of the channel are drawn again.",
+                   TimeValue (MilliSeconds (50)),
+                   MakeTimeAccessor (&FrequencySelectiveFadingModel::m_coherenceTime),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+FrequencySelectiveFadingModel::FrequencySelectiveFadingModel ()
+{
+  NS_LOG_FUNCTION (this);
+  m_gain = CreateObject<ExponentialRandomVariable> ();
+  m_gain->SetAttribute ("Mean", DoubleValue (1.0));
+}
+
+FrequencySelectiveFadingModel::~FrequencySelectiveFadingModel ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+int64_t
+FrequencySelectiveFadingModel::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_gain->SetStream (stream);
+  return 1;
+}
+
+Ptr<SpectrumValue>
+FrequencySelectiveFadingModel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                             Ptr<const MobilityModel> a,
+                                                             Ptr<const MobilityModel> b) const
+{
+  NS_LOG_FUNCTION (this << *txPsd << a << b);
+
+  // the same gains apply to both directions of a link
+  std::pair<const MobilityModel*, const MobilityModel*> key (PeekPointer (a), PeekPointer (b));
+  if (key.second < key.first)
+    {
+      std::swap (key.first, key.second);
+    }
+  Link& link = m_links[key];
+  Time now = Simulator::Now ();
+  if (link.gains.empty () || now - link.drawn >= m_coherenceTime)
+    {
+      link.gains.clear ();
+      link.drawn = now;
+    }
+
+  Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (txPsd);
+  Values::iterator vit = rxPsd->ValuesBegin ();
+  for (Bands::const_iterator fit = rxPsd->ConstBandsBegin (); fit != rxPsd->ConstBandsEnd (); ++fit, ++vit)
+    {
+      int64_t block = static_cast<int64_t> (std::floor (fit->fc / m_coherenceBandwidth));
+      auto gainIt = link.gains.find (block);
+      if (gainIt == link.gains.end ())
+        {
+          gainIt = link.gains.insert ({block, m_gain->GetValue ()}).first;
+        }
+      *vit *= gainIt->second;
+    }
+  return rxPsd;
+}
+
+} //namespace ns3
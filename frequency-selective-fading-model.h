@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FREQUENCY_SELECTIVE_FADING_MODEL_H
+#define FREQUENCY_SELECTIVE_FADING_MODEL_H
+
+#include "ns3/spectrum-propagation-loss-model.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/nstime.h"
+#include <map>
+#include <utility>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup wifi
+ *
+ * FrequencySelectiveFadingModel applies Rayleigh block fading to the power
+ * spectral density of the signals: the spectrum is divided into blocks of the
+ * coherence bandwidth and every block of every link gets an independent,
+ * exponentially distributed power gain of unit mean, which is drawn again
+ * once the coherence time has elapsed. The gains of a link are the same in
+ * both directions, so that the SNR the AP measures on the frames received
+ * from a station also holds for the frames it sends to the station. Each RU
+ * of an OFDMA PPDU thus sees a different channel, which the RU placement of
+ * RrOfdmaManager can exploit (see the SnrAwarePlacement attribute).
+ */
+class FrequencySelectiveFadingModel : public SpectrumPropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  FrequencySelectiveFadingModel ();
+  virtual ~FrequencySelectiveFadingModel ();
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.
+   *
+   * \param stream the first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+private:
+  virtual Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                           Ptr<const MobilityModel> a,
+                                                           Ptr<const MobilityModel> b) const;
+
+  /// The fading of a link
+  struct Link
+  {
+    Time drawn;                          //!< the time the gains were drawn
+    std::map<int64_t, double> gains;     //!< the power gain of each coherence block
+  };
+
+  double m_coherenceBandwidth;                        //!< the coherence bandwidth (Hz)
+  Time m_coherenceTime;                               //!< the coherence time
+  Ptr<ExponentialRandomVariable> m_gain;              //!< the power gain of a block
+  mutable std::map<std::pair<const MobilityModel*, const MobilityModel*>, Link> m_links; //!< the fading of each link
+};
+
+} //namespace ns3
+
+#endif /* FREQUENCY_SELECTIVE_FADING_MODEL_H */
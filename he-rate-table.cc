@@ -0,0 +1,46 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "he-rate-table.h"
+
+namespace ns3 {
+
+// Definitions of the tables (required when they are odr-used)
+constexpr uint16_t HeRateTable::m_ruTones[];
+constexpr uint16_t HeRateTable::m_dataSubcarriers[];
+constexpr uint8_t HeRateTable::m_bitsPerSubcarrier[];
+constexpr uint8_t HeRateTable::m_codeRateNum[];
+constexpr uint8_t HeRateTable::m_codeRateDen[];
+constexpr double HeRateTable::m_minSnrDb[];
+constexpr uint32_t HeRateTable::m_nDbps[][HeRateTable::N_MCS];
+
+// Spot checks against IEEE 802.11ax Tables 27-64 to 27-72
+static_assert (HeRateTable::GetDataBitsPerSymbol (0, 20, HeRateTable::GetRuIndex (26)) == 12, "RU26 MCS0");
+static_assert (HeRateTable::GetDataBitsPerSymbol (11, 20, HeRateTable::GetRuIndex (242)) == 1950, "RU242 MCS11");
+static_assert (HeRateTable::GetDataBitsPerSymbol (7, 20, HeRateTable::GetRuIndex (106)) == 510, "RU106 MCS7");
+// 16333.33 data bits per symbol, held exactly
+static_assert (HeRateTable::GetScaledDataBitsPerSymbol (11, HeRateTable::GetRuIndex (1992))
+               == 49000 * HeRateTable::N_DBPS_SCALE / 3, "RU2x996 MCS11");
+static_assert (HeRateTable::GetRateKbps (11, 160, 800, HeRateTable::GetRuIndex (1992)) == 1200980, "160 MHz MCS11 GI800");
+static_assert (HeRateTable::GetNSymbols (2038, HeRateTable::GetScaledDataBitsPerSymbol (11, HeRateTable::GetRuIndex (1992)))
+               == 1, "RU2x996 MCS11, one symbol");
+static_assert (HeRateTable::GetRateKbps (11, 20, 800, HeRateTable::GetRuIndex (242)) == 143382, "20 MHz MCS11 GI800");
+static_assert (HeRateTable::GetRateKbps (0, 20, 3200, HeRateTable::GetRuIndex (242)) == 7312, "20 MHz MCS0 GI3200");
+static_assert (HeRateTable::GetDataBitsPerSymbol (0, 20, HeRateTable::GetRuIndex (484)) == 0, "RU484 in 20 MHz");
+static_assert (HeRateTable::GetMaxMcs (26.0) == 7 && HeRateTable::GetMaxMcs (-3.0) == 0, "MCS from SNR");
+static_assert (HeRateTable::GetMaxMcs (40.0, 9) == 9, "MCS from SNR, capped");
+
+} //namespace ns3
@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HE_RATE_TABLE_H
+#define HE_RATE_TABLE_H
+
+#include <cstdint>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * HeRateTable provides the number of data bits per OFDM symbol and the airtime
+ * of the Data field of HE PPDUs (single spatial stream) for every combination of
+ * HE MCS (0-11), channel width (20, 40, 80, 160 MHz), guard interval (800, 1600,
+ * 3200 ns) and RU size (26 to 2x996 tones). The number of data bits per symbol,
+ * N_DBPS = N_SD * N_BPSCS * R (IEEE 802.11ax Tables 27-64 to 27-72), is not an
+ * integer for some 996-tone and 2x996-tone MCSs (e.g., 8166.67), hence the table,
+ * computed at compile time, stores N_DBPS multiplied by N_DBPS_SCALE, which all
+ * the code rate denominators divide, and all the lookups only use exact integer
+ * arithmetic.
+ *
+ * RU sizes are identified by their number of tones, as in the RU patterns used
+ * by RrOfdmaManager, or by their index in the table (see GetRuIndex).
+ */
+class HeRateTable
+{
+public:
+  static constexpr uint8_t N_MCS = 12;       //!< number of HE MCSs
+  static constexpr uint8_t N_RU_SIZES = 7;   //!< number of RU sizes
+  static constexpr uint32_t SERVICE_AND_TAIL_BITS = 16 + 6;  //!< bits added to the PSDU in the Data field
+  static constexpr uint32_t N_DBPS_SCALE = 12;  //!< factor of the stored N_DBPS, a multiple of the code rate denominators
+
+  /**
+   * \param tones the number of tones of an RU (26, 52, 106, 242, 484, 996 or 1992)
+   * \return the index of the RU size in the table, or N_RU_SIZES if invalid
+   */
+  static constexpr uint8_t GetRuIndex (uint16_t tones)
+  {
+    return tones == 26 ? 0 : tones == 52 ? 1 : tones == 106 ? 2 : tones == 242 ? 3
+           : tones == 484 ? 4 : tones == 996 ? 5 : tones == 1992 ? 6 : N_RU_SIZES;
+  }
+  /**
+   * \param ruIndex the index of an RU size
+   * \return the number of tones of the RU
+   */
+  static constexpr uint16_t GetRuTones (uint8_t ruIndex)
+  {
+    return m_ruTones[ruIndex];
+  }
+  /**
+   * \param width the channel width in MHz
+   * \return the number of tones of the RU spanning the whole channel
+   */
+  static constexpr uint16_t GetFullBandRuTones (uint16_t width)
+  {
+    return width == 20 ? 242 : width == 40 ? 484 : width == 80 ? 996 : 1992;
+  }
+  /**
+   * \param width the channel width in MHz
+   * \param ruIndex the index of an RU size
+   * \return true if an RU of the given size can be allocated in a channel of the given width
+   */
+  static constexpr bool IsValid (uint16_t width, uint8_t ruIndex)
+  {
+    return ruIndex < N_RU_SIZES && m_ruTones[ruIndex] <= GetFullBandRuTones (width);
+  }
+  /**
+   * \param mcs the HE MCS
+   * \param ruIndex the index of an RU size
+   * \return the number of data bits per OFDM symbol multiplied by N_DBPS_SCALE
+   */
+  static constexpr uint32_t GetScaledDataBitsPerSymbol (uint8_t mcs, uint8_t ruIndex)
+  {
+    return m_nDbps[ruIndex][mcs];
+  }
+  /**
+   * \param mcs the HE MCS
+   * \param width the channel width in MHz
+   * \param ruIndex the index of an RU size
+   * \return the number of data bits per OFDM symbol multiplied by N_DBPS_SCALE,
+   *         or zero if the RU is not valid for the given channel width
+   */
+  static constexpr uint32_t GetScaledDataBitsPerSymbol (uint8_t mcs, uint16_t width, uint8_t ruIndex)
+  {
+    return IsValid (width, ruIndex) && mcs < N_MCS ? m_nDbps[ruIndex][mcs] : 0;
+  }
+  /**
+   * \param mcs the HE MCS
+   * \param width the channel width in MHz
+   * \param ruIndex the index of an RU size
+   * \return the number of data bits per OFDM symbol, rounded down, or zero if
+   *         the RU is not valid for the given channel width
+   */
+  static constexpr uint32_t GetDataBitsPerSymbol (uint8_t mcs, uint16_t width, uint8_t ruIndex)
+  {
+    return GetScaledDataBitsPerSymbol (mcs, width, ruIndex) / N_DBPS_SCALE;
+  }
+  /**
+   * \param guardInterval the guard interval in nanoseconds (800, 1600 or 3200)
+   * \return the duration of an HE OFDM symbol (including the guard interval) in nanoseconds
+   */
+  static constexpr uint32_t GetSymbolDurationNs (uint16_t guardInterval)
+  {
+    return 12800 + guardInterval;
+  }
+  /**
+   * \param bytes the size of a PSDU in bytes
+   * \param scaledNDbps the number of data bits per symbol multiplied by N_DBPS_SCALE
+   * \return the number of OFDM symbols of the Data field carrying the PSDU
+   */
+  static constexpr uint32_t GetNSymbols (uint32_t bytes, uint32_t scaledNDbps)
+  {
+    return static_cast<uint32_t> (((SERVICE_AND_TAIL_BITS + UINT64_C (8) * bytes) * N_DBPS_SCALE + scaledNDbps - 1)
+                                  / scaledNDbps);
+  }
+  /**
+   * \param bytes the size of a PSDU in bytes
+   * \param mcs the HE MCS
+   * \param width the channel width in MHz
+   * \param guardInterval the guard interval in nanoseconds
+   * \param ruIndex the index of an RU size
+   * \return the duration (ns) of the Data field carrying the PSDU, or zero if the
+   *         RU is not valid for the given channel width
+   */
+  static constexpr uint64_t GetAirtimeNs (uint32_t bytes, uint8_t mcs, uint16_t width,
+                                          uint16_t guardInterval, uint8_t ruIndex)
+  {
+    return GetScaledDataBitsPerSymbol (mcs, width, ruIndex) == 0
+           ? 0
+           : static_cast<uint64_t> (GetNSymbols (bytes, m_nDbps[ruIndex][mcs]))
+             * GetSymbolDurationNs (guardInterval);
+  }
+  /**
+   * \param durationNs a duration in nanoseconds
+   * \param mcs the HE MCS
+   * \param width the channel width in MHz
+   * \param guardInterval the guard interval in nanoseconds
+   * \param ruIndex the index of an RU size
+   * \return the number of bytes that the Data field can carry in the given duration
+   */
+  static constexpr uint32_t GetBytesInDuration (uint64_t durationNs, uint8_t mcs, uint16_t width,
+                                                uint16_t guardInterval, uint8_t ruIndex)
+  {
+    return durationNs / GetSymbolDurationNs (guardInterval) * GetScaledDataBitsPerSymbol (mcs, width, ruIndex)
+           / N_DBPS_SCALE < SERVICE_AND_TAIL_BITS
+           ? 0
+           : static_cast<uint32_t> ((durationNs / GetSymbolDurationNs (guardInterval)
+                                     * GetScaledDataBitsPerSymbol (mcs, width, ruIndex) / N_DBPS_SCALE
+                                     - SERVICE_AND_TAIL_BITS) / 8);
+  }
+  /**
+   * \param mcs the HE MCS
+   * \return the SNR (dB) above which the MCS is deemed decodable
+   */
+  static constexpr double GetMinSnrDb (uint8_t mcs)
+  {
+    return m_minSnrDb[mcs];
+  }
+  /**
+   * \param snrDb an SNR in dB
+   * \param mcs the highest MCS to consider
+   * \return the highest MCS (not above the given one) decodable at the given
+   *         SNR, or MCS 0 if none is
+   */
+  static constexpr uint8_t GetMaxMcs (double snrDb, uint8_t mcs = N_MCS - 1)
+  {
+    return mcs == 0 || snrDb >= m_minSnrDb[mcs] ? mcs : GetMaxMcs (snrDb, mcs - 1);
+  }
+  /**
+   * \param mcs the HE MCS
+   * \param width the channel width in MHz
+   * \param guardInterval the guard interval in nanoseconds
+   * \param ruIndex the index of an RU size
+   * \return the PHY rate in kbit/s
+   */
+  static constexpr uint32_t GetRateKbps (uint8_t mcs, uint16_t width, uint16_t guardInterval, uint8_t ruIndex)
+  {
+    return static_cast<uint32_t> (GetScaledDataBitsPerSymbol (mcs, width, ruIndex) * UINT64_C (1000000)
+                                  / (N_DBPS_SCALE * GetSymbolDurationNs (guardInterval)));
+  }
+
+private:
+  static constexpr uint16_t m_ruTones[N_RU_SIZES] = {26, 52, 106, 242, 484, 996, 1992};       //!< tones per RU
+  static constexpr uint16_t m_dataSubcarriers[N_RU_SIZES] = {24, 48, 102, 234, 468, 980, 1960}; //!< N_SD per RU
+  static constexpr uint8_t m_bitsPerSubcarrier[N_MCS] = {1, 2, 2, 4, 4, 6, 6, 6, 8, 8, 10, 10}; //!< N_BPSCS per MCS
+  static constexpr uint8_t m_codeRateNum[N_MCS] = {1, 1, 3, 1, 3, 2, 3, 5, 3, 5, 3, 5};         //!< code rate numerator
+  static constexpr uint8_t m_codeRateDen[N_MCS] = {2, 2, 4, 2, 4, 3, 4, 6, 4, 6, 4, 6};         //!< code rate denominator
+  static constexpr double m_minSnrDb[N_MCS] = {2, 5, 9, 11, 15, 18, 20, 25, 29, 31, 34, 37};   //!< min SNR (dB) per MCS
+
+  /// N_DBPS = N_SD * N_BPSCS * R of the given RU size index and MCS, multiplied by N_DBPS_SCALE
+#define HE_RATE_TABLE_NDBPS(ru, mcs) \
+  (m_dataSubcarriers[ru] * m_bitsPerSubcarrier[mcs] * m_codeRateNum[mcs] * (N_DBPS_SCALE / m_codeRateDen[mcs]))
+  /// N_DBPS of the given RU size index for all the MCSs
+#define HE_RATE_TABLE_ROW(ru)                                                     \
+  { HE_RATE_TABLE_NDBPS (ru, 0), HE_RATE_TABLE_NDBPS (ru, 1), HE_RATE_TABLE_NDBPS (ru, 2),   \
+    HE_RATE_TABLE_NDBPS (ru, 3), HE_RATE_TABLE_NDBPS (ru, 4), HE_RATE_TABLE_NDBPS (ru, 5),   \
+    HE_RATE_TABLE_NDBPS (ru, 6), HE_RATE_TABLE_NDBPS (ru, 7), HE_RATE_TABLE_NDBPS (ru, 8),   \
+    HE_RATE_TABLE_NDBPS (ru, 9), HE_RATE_TABLE_NDBPS (ru, 10), HE_RATE_TABLE_NDBPS (ru, 11) }
+
+  /// N_DBPS (multiplied by N_DBPS_SCALE) indexed by RU size index and MCS, computed at compile time
+  static constexpr uint32_t m_nDbps[N_RU_SIZES][N_MCS] = {
+    HE_RATE_TABLE_ROW (0), HE_RATE_TABLE_ROW (1), HE_RATE_TABLE_ROW (2), HE_RATE_TABLE_ROW (3),
+    HE_RATE_TABLE_ROW (4), HE_RATE_TABLE_ROW (5), HE_RATE_TABLE_ROW (6)
+  };
+
+#undef HE_RATE_TABLE_ROW
+#undef HE_RATE_TABLE_NDBPS
+};
+
+} //namespace ns3
+
+#endif /* HE_RATE_TABLE_H */
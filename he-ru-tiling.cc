@@ -0,0 +1,333 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "he-ru-tiling.h"
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace ns3 {
+
+namespace {
+
+/**
+ * \param a a subcarrier group
+ * \param b another subcarrier group
+ * \return true if the two subcarrier groups share at least one subcarrier
+ */
+bool
+SharesSubcarriers (const HeRu::SubcarrierGroup& a, const HeRu::SubcarrierGroup& b)
+{
+  for (auto& ra : a)
+    {
+      for (auto& rb : b)
+        {
+          if (ra.first <= rb.second && rb.first <= ra.second)
+            {
+              return true;
+            }
+        }
+    }
+  return false;
+}
+
+} // unnamed namespace
+
+const HeRuTiling&
+HeRuTiling::Get (uint16_t width)
+{
+  static std::map<uint16_t, HeRuTiling> tilings;
+
+  auto it = tilings.find (width);
+  if (it == tilings.end ())
+    {
+      it = tilings.insert ({width, HeRuTiling (width)}).first;
+    }
+  return it->second;
+}
+
+uint8_t
+HeRuTiling::GetSizeIndex (HeRu::RuType ruType)
+{
+  switch (ruType)
+    {
+    case HeRu::RU_26_TONE:
+      return 0;
+    case HeRu::RU_52_TONE:
+      return 1;
+    case HeRu::RU_106_TONE:
+      return 2;
+    case HeRu::RU_242_TONE:
+      return 3;
+    case HeRu::RU_484_TONE:
+      return 4;
+    case HeRu::RU_996_TONE:
+      return 5;
+    case HeRu::RU_2x996_TONE:
+      return 6;
+    default:
+      NS_ASSERT_MSG (false, "Unknown RU type");
+      return HeRateTable::N_RU_SIZES;
+    }
+}
+
+HeRuTiling::HeRuTiling (uint16_t width)
+  : m_width (width),
+    m_nRusMask {{0, 0}},
+    m_channelMask {{0, 0}}
+{
+  NS_ASSERT (width == 20 || width == 40 || width == 80 || width == 160);
+
+  // a 160 MHz channel is made of two 80 MHz segments, identified by the
+  // primary80MHz flag of the RU spec
+  uint16_t segmentWidth = (width == 160 ? 80 : width);
+  std::vector<bool> segments {true};
+  if (width == 160)
+    {
+      segments.push_back (false);
+    }
+
+  const std::vector<HeRu::SubcarrierGroup>& positions =
+    HeRu::m_heRuSubcarrierGroups.at ({segmentWidth, HeRu::RU_26_TONE});
+  std::size_t nPositions = positions.size () * segments.size ();
+  NS_ASSERT (nPositions <= 128);
+
+  // list all the RUs of the channel along with the 26-tone RU positions they cover
+  for (std::size_t s = 0; s < segments.size (); s++)
+    {
+      std::size_t offset = s * positions.size ();
+
+      for (auto& entry : HeRu::m_heRuSubcarrierGroups)
+        {
+          if (entry.first.first != segmentWidth)
+            {
+              continue;
+            }
+          for (std::size_t k = 0; k < entry.second.size (); k++)
+            {
+              ChannelRu ru {{segments[s], entry.first.second, k + 1}, {{0, 0}}, nPositions, 0};
+              for (std::size_t p = 0; p < positions.size (); p++)
+                {
+                  if (SharesSubcarriers (entry.second[k], positions[p]))
+                    {
+                      ru.first = std::min (ru.first, p + offset);
+                      ru.last = std::max (ru.last, p + offset);
+                      ru.mask[(p + offset) / 64] |= (uint64_t (1) << ((p + offset) % 64));
+                    }
+                }
+              NS_ASSERT_MSG (ru.first <= ru.last, "RU does not cover any 26-tone RU");
+              m_rus[GetSizeIndex (entry.first.second)].push_back (ru);
+            }
+        }
+    }
+  if (width == 160)
+    {
+      ChannelRu ru {{true, HeRu::RU_2x996_TONE, 1}, {{0, 0}}, 0, nPositions - 1};
+      for (std::size_t p = 0; p < nPositions; p++)
+        {
+          ru.mask[p / 64] |= (uint64_t (1) << (p % 64));
+        }
+      m_rus[GetSizeIndex (HeRu::RU_2x996_TONE)].push_back (ru);
+    }
+  for (auto& rus : m_rus)
+    {
+      for (auto& ru : rus)
+        {
+          std::size_t count = 0;
+          for (auto word : ru.mask)
+            {
+              for (; word != 0; word &= word - 1)
+                {
+                  count++;
+                }
+            }
+          NS_ASSERT_MSG (count == ru.last - ru.first + 1,
+                         "RU does not cover a contiguous range of 26-tone RUs");
+        }
+    }
+
+  for (std::size_t p = 0; p < nPositions; p++)
+    {
+      m_channelMask[p / 64] |= (uint64_t (1) << (p % 64));
+    }
+
+  // covers[p] holds the composition of every tiling of the positions p, p+1, ...
+  std::vector<std::set<Composition>> covers (nPositions + 1);
+  covers[nPositions].insert (Composition {});
+
+  for (std::size_t p = nPositions; p-- > 0; )
+    {
+      for (uint8_t size = 0; size < HeRateTable::N_RU_SIZES; size++)
+        {
+          for (auto& ru : m_rus[size])
+            {
+              if (ru.first != p)
+                {
+                  continue;
+                }
+              for (auto& next : covers[ru.last + 1])
+                {
+                  Composition composition = next;
+                  composition[size]++;
+                  covers[p].insert (composition);
+                }
+            }
+        }
+    }
+
+  for (auto& composition : covers[0])
+    {
+      std::size_t nRus = 0;
+      for (auto count : composition)
+        {
+          nRus += count;
+        }
+      m_tilings.push_back ({composition, nRus});
+    }
+  std::stable_sort (m_tilings.begin (), m_tilings.end (),
+                    [] (const Tiling& a, const Tiling& b) { return a.nRus < b.nRus; });
+
+  m_nTilings.assign (nPositions + 1, 0);
+  for (auto& tiling : m_tilings)
+    {
+      NS_ASSERT (tiling.nRus <= nPositions && tiling.nRus < 128);
+      m_nRusMask[tiling.nRus / 64] |= (uint64_t (1) << (tiling.nRus % 64));
+      for (std::size_t n = tiling.nRus; n <= nPositions; n++)
+        {
+          m_nTilings[n]++;
+        }
+    }
+
+#ifdef NS3_ASSERT_ENABLE
+  // the RUs of every tiling can be placed largest first in an empty channel
+  std::vector<uint8_t> sizes;
+  std::vector<HeRu::RuSpec> rus;
+  for (auto& tiling : m_tilings)
+    {
+      sizes.clear ();
+      for (uint8_t size = HeRateTable::N_RU_SIZES; size-- > 0; )
+        {
+          sizes.insert (sizes.end (), tiling.composition[size], size);
+        }
+      Mask occupied {{0, 0}};
+      NS_ASSERT (Place (sizes, occupied, rus));
+    }
+#endif
+}
+
+uint16_t
+HeRuTiling::GetChannelWidth (void) const
+{
+  return m_width;
+}
+
+std::size_t
+HeRuTiling::GetMaxRus (void) const
+{
+  return m_nTilings.size () - 1;
+}
+
+bool
+HeRuTiling::HasTilings (std::size_t nRus) const
+{
+  return nRus < 128 && ((m_nRusMask[nRus / 64] >> (nRus % 64)) & 1) != 0;
+}
+
+std::size_t
+HeRuTiling::GetNTilings (std::size_t maxRus) const
+{
+  return m_nTilings[std::min (maxRus, GetMaxRus ())];
+}
+
+const HeRuTiling::Tiling&
+HeRuTiling::GetTiling (std::size_t i) const
+{
+  NS_ASSERT (i < m_tilings.size ());
+  return m_tilings[i];
+}
+
+std::size_t
+HeRuTiling::GetNRus (uint8_t sizeIndex) const
+{
+  NS_ASSERT (sizeIndex < HeRateTable::N_RU_SIZES);
+  return m_rus[sizeIndex].size ();
+}
+
+const HeRu::RuSpec&
+HeRuTiling::GetRu (uint8_t sizeIndex, std::size_t i) const
+{
+  NS_ASSERT (sizeIndex < HeRateTable::N_RU_SIZES && i < m_rus[sizeIndex].size ());
+  return m_rus[sizeIndex][i].spec;
+}
+
+const HeRuTiling::Mask&
+HeRuTiling::GetMask (uint8_t sizeIndex, std::size_t i) const
+{
+  NS_ASSERT (sizeIndex < HeRateTable::N_RU_SIZES && i < m_rus[sizeIndex].size ());
+  return m_rus[sizeIndex][i].mask;
+}
+
+const HeRuTiling::Mask&
+HeRuTiling::GetMask (const HeRu::RuSpec& ru) const
+{
+  uint8_t sizeIndex = GetSizeIndex (ru.ruType);
+  // the RUs of a 160 MHz channel are listed per 80 MHz segment, primary first
+  std::size_t offset = 0;
+  if (m_width == 160 && ru.ruType != HeRu::RU_2x996_TONE && !ru.primary80MHz)
+    {
+      offset = m_rus[sizeIndex].size () / 2;
+    }
+  NS_ASSERT (ru.index >= 1);
+  return GetMask (sizeIndex, offset + ru.index - 1);
+}
+
+const HeRuTiling::Mask&
+HeRuTiling::GetChannelMask (void) const
+{
+  return m_channelMask;
+}
+
+bool
+HeRuTiling::Place (const std::vector<uint8_t>& sizes, Mask& occupied, std::vector<HeRu::RuSpec>& rus) const
+{
+  rus.clear ();
+  for (std::size_t k = 0; k < sizes.size (); k++)
+    {
+      NS_ASSERT (sizes[k] < HeRateTable::N_RU_SIZES);
+      NS_ASSERT_MSG (k == 0 || sizes[k] <= sizes[k - 1], "RU sizes must be sorted by decreasing size");
+
+      bool placed = false;
+      for (auto& ru : m_rus[sizes[k]])
+        {
+          if (!Overlap (occupied, ru.mask))
+            {
+              occupied[0] |= ru.mask[0];
+              occupied[1] |= ru.mask[1];
+              rus.push_back (ru.spec);
+              placed = true;
+              break;
+            }
+        }
+      if (!placed)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+} //namespace ns3
@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HE_RU_TILING_H
+#define HE_RU_TILING_H
+
+#include "he-ru.h"
+#include "he-rate-table.h"
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * HeRuTiling lists all the ways a channel of a given width can be fully
+ * tiled by non-overlapping RUs of mixed sizes. The RUs of the channel are
+ * taken from HeRu::m_heRuSubcarrierGroups: each of them covers a contiguous
+ * range of 26-tone RU positions (determined by the overlap of the subcarrier
+ * ranges), hence the tilings are enumerated by an exact cover dynamic program
+ * over such positions. A 160 MHz channel is tiled either by a 2x996-tone RU or
+ * by a tiling of each of its 80 MHz segments.
+ *
+ * Many tilings have the same composition (number of RUs of each size) and are
+ * equivalent to an allocator that is not aware of the channel conditions.
+ * Hence, only the compositions are stored, sorted by increasing number of RUs,
+ * and a bitmask tells which numbers of RUs can be obtained. The RU indices are
+ * assigned when the RUs are placed in the channel: the occupancy of the channel
+ * is a bitmap over the 26-tone RU positions (at most 74, i.e., two 64-bit
+ * words), so that checking whether an RU overlaps the RUs already placed takes
+ * a couple of bitwise operations. The tilings of each channel width are
+ * generated only once and shared by all the users.
+ */
+class HeRuTiling
+{
+public:
+  /// Number of RUs of each size (indexed by the RU size index of HeRateTable)
+  typedef std::array<uint8_t, HeRateTable::N_RU_SIZES> Composition;
+
+  /// Bitmap of the 26-tone RU positions of the channel (bit p of word p / 64)
+  typedef std::array<uint64_t, 2> Mask;
+
+  /// A tiling of the channel
+  struct Tiling
+  {
+    Composition composition;          //!< the number of RUs of each size
+    std::size_t nRus;                 //!< the total number of RUs
+  };
+
+  /**
+   * \param width the channel width in MHz (20, 40, 80 or 160)
+   * \return the tilings of a channel of the given width
+   */
+  static const HeRuTiling& Get (uint16_t width);
+
+  /**
+   * \param ruType the RU type
+   * \return the index of the RU size in HeRateTable
+   */
+  static uint8_t GetSizeIndex (HeRu::RuType ruType);
+
+  /**
+   * \param a a bitmap of RU positions
+   * \param b another bitmap of RU positions
+   * \return true if the two bitmaps have at least one position in common
+   */
+  static bool Overlap (const Mask& a, const Mask& b)
+  {
+    return ((a[0] & b[0]) | (a[1] & b[1])) != 0;
+  }
+
+  /**
+   * \return the channel width in MHz
+   */
+  uint16_t GetChannelWidth (void) const;
+  /**
+   * \return the maximum number of RUs in a tiling (i.e., the number of 26-tone RUs)
+   */
+  std::size_t GetMaxRus (void) const;
+  /**
+   * \param nRus a number of RUs
+   * \return true if the channel can be tiled by exactly the given number of RUs
+   */
+  bool HasTilings (std::size_t nRus) const;
+  /**
+   * \param maxRus a number of RUs
+   * \return the number of tilings made of at most the given number of RUs,
+   *         which are the first tilings
+   */
+  std::size_t GetNTilings (std::size_t maxRus) const;
+  /**
+   * \param i the index of a tiling
+   * \return the tiling
+   */
+  const Tiling& GetTiling (std::size_t i) const;
+
+  /**
+   * \param sizeIndex the index of an RU size in HeRateTable
+   * \return the number of RUs of the given size in the channel
+   */
+  std::size_t GetNRus (uint8_t sizeIndex) const;
+  /**
+   * \param sizeIndex the index of an RU size in HeRateTable
+   * \param i the index (from zero, in frequency order) of an RU of the given size
+   * \return the RU
+   */
+  const HeRu::RuSpec& GetRu (uint8_t sizeIndex, std::size_t i) const;
+  /**
+   * \param sizeIndex the index of an RU size in HeRateTable
+   * \param i the index (from zero, in frequency order) of an RU of the given size
+   * \return the positions occupied by the RU
+   */
+  const Mask& GetMask (uint8_t sizeIndex, std::size_t i) const;
+  /**
+   * \param ru an RU of the channel (the primary80MHz flag is only relevant
+   *           to 160 MHz channels)
+   * \return the positions occupied by the RU
+   */
+  const Mask& GetMask (const HeRu::RuSpec& ru) const;
+  /**
+   * \return the positions of the whole channel
+   */
+  const Mask& GetChannelMask (void) const;
+  /**
+   * Place RUs of the given sizes in the channel, largest first, each at the
+   * lowest frequency where it does not overlap the occupied positions. Placing
+   * the RUs of any tiling composition in an empty channel always succeeds.
+   *
+   * \param sizes the indices of the sizes of the RUs, in decreasing order
+   * \param occupied the occupied positions, updated with the placed RUs
+   * \param rus the placed RUs, in the same order as the sizes
+   * \return true if all the RUs could be placed
+   */
+  bool Place (const std::vector<uint8_t>& sizes, Mask& occupied, std::vector<HeRu::RuSpec>& rus) const;
+
+private:
+  /// An RU of the channel
+  struct ChannelRu
+  {
+    HeRu::RuSpec spec;    //!< the RU
+    Mask mask;            //!< the 26-tone RU positions covered
+    std::size_t first;    //!< the first 26-tone RU position covered
+    std::size_t last;     //!< the last 26-tone RU position covered
+  };
+
+  /**
+   * Enumerate the tilings of a channel of the given width.
+   *
+   * \param width the channel width in MHz
+   */
+  explicit HeRuTiling (uint16_t width);
+
+  uint16_t m_width;                        //!< the channel width
+  std::array<std::vector<ChannelRu>, HeRateTable::N_RU_SIZES> m_rus;  //!< the RUs of each size
+  std::vector<Tiling> m_tilings;           //!< the tilings, sorted by number of RUs
+  std::vector<std::size_t> m_nTilings;     //!< number of tilings with at most n RUs, indexed by n
+  std::array<uint64_t, 2> m_nRusMask;      //!< bit n set if a tiling with exactly n RUs exists
+  Mask m_channelMask;                      //!< all the positions of the channel
+};
+
+} //namespace ns3
+
+#endif /* HE_RU_TILING_H */
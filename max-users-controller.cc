@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "max-users-controller.h"
+#include <algorithm>
+
+namespace ns3 {
+
+namespace {
+
+/// the completeness below which the MU PPDUs are deemed mostly padding
+const double g_minCompleteness = 0.5;
+/// the relative throughput loss deemed a degradation
+const double g_tolerance = 0.02;
+
+} // unnamed namespace
+
+MaxUsersController::MaxUsersController ()
+  : m_cap (1),
+    m_maxCap (1),
+    m_epoch (32),
+    m_targetDelay (50000000),
+    m_direction (1),
+    m_lastThroughput (0),
+    m_decisions (0),
+    m_backlogged (0),
+    m_maxDelay (0),
+    m_ppdus (0),
+    m_completeness (0),
+    m_bytes (0),
+    m_airtime (0)
+{
+}
+
+void
+MaxUsersController::SetCap (std::size_t initial, std::size_t max)
+{
+  NS_ASSERT (max >= 1);
+  m_maxCap = max;
+  m_cap = std::max<std::size_t> (std::min (initial, max), 1);
+}
+
+void
+MaxUsersController::SetEpoch (std::size_t decisions)
+{
+  NS_ASSERT (decisions > 0);
+  m_epoch = decisions;
+}
+
+void
+MaxUsersController::SetTargetDelay (int64_t delay)
+{
+  m_targetDelay = delay;
+}
+
+std::size_t
+MaxUsersController::GetMaxUsers (void) const
+{
+  return m_cap;
+}
+
+void
+MaxUsersController::NotifyDecision (const StaStateTable& table, int64_t now)
+{
+  const std::vector<uint16_t>& candidates = table.GetCandidates ();
+  m_backlogged += candidates.size ();
+
+  if (!candidates.empty ())
+    {
+      m_delays.clear ();
+      for (auto aid : candidates)
+        {
+          m_delays.push_back (now - table.GetHolTimestamp (aid));
+        }
+      auto percentile = m_delays.begin () + (m_delays.size () * 9) / 10;
+      std::nth_element (m_delays.begin (), percentile, m_delays.end ());
+      m_maxDelay = std::max (m_maxDelay, *percentile);
+    }
+
+  if (++m_decisions == m_epoch)
+    {
+      Update ();
+    }
+}
+
+void
+MaxUsersController::NotifyPpdu (double completeness, uint64_t bytes, uint64_t airtime)
+{
+  m_ppdus++;
+  m_completeness += completeness;
+  m_bytes += bytes;
+  m_airtime += airtime;
+}
+
+void
+MaxUsersController::Update (void)
+{
+  double backlogged = static_cast<double> (m_backlogged) / m_decisions;
+
+  if (m_ppdus > 0)
+    {
+      double completeness = m_completeness / m_ppdus;
+      double throughput = (m_airtime > 0 ? m_bytes * 1e9 / m_airtime : 0);
+
+      if (completeness < g_minCompleteness)
+        {
+          m_direction = -1;
+        }
+      else if (m_maxDelay > m_targetDelay)
+        {
+          m_direction = 1;
+        }
+      else if (throughput < m_lastThroughput * (1 - g_tolerance))
+        {
+          m_direction = -m_direction;
+        }
+      m_lastThroughput = throughput;
+
+      std::size_t step = std::max<std::size_t> (m_cap / 4, 1);
+      m_cap = (m_direction > 0 ? m_cap + step : (m_cap > step ? m_cap - step : 1));
+    }
+
+  // no need for a cap larger than the number of backlogged stations
+  std::size_t maxCap = std::min (m_maxCap, std::max<std::size_t> (static_cast<std::size_t> (backlogged + 0.5), 1));
+  m_cap = std::min (m_cap, maxCap);
+
+  m_decisions = 0;
+  m_backlogged = 0;
+  m_maxDelay = 0;
+  m_ppdus = 0;
+  m_completeness = 0;
+  m_bytes = 0;
+  m_airtime = 0;
+}
+
+} //namespace ns3
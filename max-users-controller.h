@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MAX_USERS_CONTROLLER_H
+#define MAX_USERS_CONTROLLER_H
+
+#include "sta-state-table.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * MaxUsersController retunes online the maximum number of stations that can
+ * be granted an RU in a DL MU PPDU. Every epoch (a given number of scheduling
+ * decisions), it considers the average number of backlogged stations, the
+ * 90th percentile of the head-of-line delay of the candidates, the average
+ * completeness of the MU PPDUs (the time the users spend transmitting data,
+ * relative to the duration of the PPDU, i.e., one minus the padding) and the
+ * delivered throughput (bytes per unit of MU PPDU airtime):
+ *
+ * - if the PPDUs are mostly padding, the cap is decreased: fewer, larger RUs;
+ * - else, if the delay exceeds the target, the cap is increased: many small
+ *   RUs serve more stations per PPDU;
+ * - otherwise, the cap keeps moving in the same direction as long as the
+ *   throughput improves, and in the opposite direction when it degrades.
+ *
+ * The cap moves by a quarter of its value (at least one) and is kept between
+ * one and the largest number of RUs of the channel; the cap is also never
+ * larger than the average number of backlogged stations, so that it reacts
+ * quickly when the load increases.
+ */
+class MaxUsersController
+{
+public:
+  MaxUsersController ();
+
+  /**
+   * Set the range and the initial value of the cap.
+   *
+   * \param initial the initial cap
+   * \param max the largest cap (e.g., the number of 26-tone RUs of the channel)
+   */
+  void SetCap (std::size_t initial, std::size_t max);
+  /**
+   * \param decisions the number of scheduling decisions per epoch
+   */
+  void SetEpoch (std::size_t decisions);
+  /**
+   * \param delay the target 90th percentile of the head-of-line delay (ns)
+   */
+  void SetTargetDelay (int64_t delay);
+
+  /**
+   * Notify a scheduling decision.
+   *
+   * \param table the state of the stations, including the candidates
+   * \param now the current time (ns)
+   */
+  void NotifyDecision (const StaStateTable& table, int64_t now);
+  /**
+   * Notify the transmission of an MU PPDU.
+   *
+   * \param completeness the ratio between the average time the users transmit
+   *                     data and the duration of the Data field
+   * \param bytes the bytes sent to all the users
+   * \param airtime the duration (ns) of the PPDU
+   */
+  void NotifyPpdu (double completeness, uint64_t bytes, uint64_t airtime);
+
+  /**
+   * \return the current cap
+   */
+  std::size_t GetMaxUsers (void) const;
+
+private:
+  /// Adjust the cap at the end of an epoch
+  void Update (void);
+
+  std::size_t m_cap;                  //!< the current cap
+  std::size_t m_maxCap;               //!< the largest cap
+  std::size_t m_epoch;                //!< the number of decisions per epoch
+  int64_t m_targetDelay;              //!< the target HOL delay percentile (ns)
+  int m_direction;                    //!< the direction of the last move (+1 or -1)
+  double m_lastThroughput;            //!< the throughput (bytes/s) of the previous epoch
+  // statistics of the current epoch
+  std::size_t m_decisions;            //!< the number of decisions
+  std::size_t m_backlogged;           //!< the sum of the number of candidates
+  int64_t m_maxDelay;                 //!< the largest HOL delay percentile (ns)
+  std::size_t m_ppdus;                //!< the number of MU PPDUs
+  double m_completeness;              //!< the sum of the completeness of the MU PPDUs
+  uint64_t m_bytes;                   //!< the bytes sent in MU PPDUs
+  uint64_t m_airtime;                 //!< the airtime (ns) of the MU PPDUs
+  std::vector<int64_t> m_delays;      //!< scratch vector of HOL delays
+};
+
+} //namespace ns3
+
+#endif /* MAX_USERS_CONTROLLER_H */
@@ -0,0 +1,70 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mlwdf-ranking.h"
+#include <algorithm>
+
+namespace ns3 {
+
+bool
+MlwdfRanking::RanksBefore::operator() (std::size_t a, std::size_t b) const
+{
+  if ((*weights)[a] != (*weights)[b])
+    {
+      return (*weights)[a] > (*weights)[b];
+    }
+  return a < b;
+}
+
+MlwdfRanking::MlwdfRanking ()
+{
+}
+
+const std::vector<std::size_t>&
+MlwdfRanking::SelectTopK (const std::vector<double>& weights, std::size_t k)
+{
+  RanksBefore ranksBefore {&weights};
+  k = std::min (k, weights.size ());
+  m_heap.clear ();
+
+  if (k == 0)
+    {
+      return m_heap;
+    }
+
+  // With the "ranks before" ordering, the front of the heap is the worst of the
+  // candidates kept so far, which is the one to evict when a better one shows up
+  for (std::size_t i = 0; i < k; i++)
+    {
+      m_heap.push_back (i);
+    }
+  std::make_heap (m_heap.begin (), m_heap.end (), ranksBefore);
+
+  for (std::size_t i = k; i < weights.size (); i++)
+    {
+      if (ranksBefore (i, m_heap.front ()))
+        {
+          std::pop_heap (m_heap.begin (), m_heap.end (), ranksBefore);
+          m_heap.back () = i;
+          std::push_heap (m_heap.begin (), m_heap.end (), ranksBefore);
+        }
+    }
+
+  std::sort_heap (m_heap.begin (), m_heap.end (), ranksBefore);
+  return m_heap;
+}
+
+} //namespace ns3
@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MLWDF_RANKING_H
+#define MLWDF_RANKING_H
+
+#include <cstddef>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * MlwdfRanking selects, among the candidate stations of a scheduling pass, the
+ * K stations having the largest M-LWDF weight. A bounded heap holding the indices
+ * of the best K candidates seen so far is maintained, hence the selection costs
+ * O(N log K) for N candidates, instead of sorting the whole candidate set.
+ * Ties are broken in favor of the candidate with the lowest index (i.e., the
+ * lowest AID when the weights are read from StaStateTable).
+ *
+ * This class does not depend on the simulator and can be exercised on its own
+ * (see ofdma-scheduler-bench.cc).
+ */
+class MlwdfRanking
+{
+public:
+  MlwdfRanking ();
+
+  /**
+   * Select the (at most) k candidates with the largest weights.
+   *
+   * \param weights the weight of each candidate
+   * \param k the maximum number of candidates to select
+   * \return the indices (in the given vector of weights) of the selected
+   *         candidates, sorted by decreasing weight. The returned reference
+   *         is valid until the next call to this method
+   */
+  const std::vector<std::size_t>& SelectTopK (const std::vector<double>& weights, std::size_t k);
+
+private:
+  /**
+   * Ordering used by the heap: return true if candidate a ranks before candidate b.
+   */
+  struct RanksBefore
+  {
+    const std::vector<double>* weights; //!< the weights of the candidates
+
+    /**
+     * \param a the index of a candidate
+     * \param b the index of another candidate
+     * \return true if candidate a ranks before candidate b
+     */
+    bool operator() (std::size_t a, std::size_t b) const;
+  };
+
+  std::vector<std::size_t> m_heap;  //!< indices of the best candidates found so far
+};
+
+} //namespace ns3
+
+#endif /* MLWDF_RANKING_H */
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mlwdf-weight-kernel.h"
+#include <cstring>
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define MLWDF_WEIGHT_KERNEL_AVX2
+#include <immintrin.h>
+#endif
+
+namespace ns3 {
+
+namespace {
+
+/**
+ * Compute the weights of the stations from begin to n, one at a time.
+ *
+ * \param begin the first station
+ * \copydetails MlwdfWeightKernel::Compute
+ */
+inline void
+ComputeRange (std::size_t begin, std::size_t n, const uint8_t* trafficClass, const uint8_t* mcs,
+              const double* holDelay, const double* avgThroughput,
+              const StaStateTable::ClassCoefficients& coefficient,
+              const StaStateTable::McsRates& rate, double* weight)
+{
+  for (std::size_t i = begin; i < n; i++)
+    {
+      weight[i] = (trafficClass[i] != TrafficClassifier::UNKNOWN
+                   ? coefficient[trafficClass[i]] * holDelay[i] * rate[mcs[i]] / avgThroughput[i]
+                   : 0.0);
+    }
+}
+
+#ifdef MLWDF_WEIGHT_KERNEL_AVX2
+/**
+ * \copydoc MlwdfWeightKernel::Compute
+ */
+__attribute__ ((target ("avx2"))) void
+ComputeAvx2 (std::size_t n, const uint8_t* trafficClass, const uint8_t* mcs,
+             const double* holDelay, const double* avgThroughput,
+             const StaStateTable::ClassCoefficients& coefficient,
+             const StaStateTable::McsRates& rate, double* weight)
+{
+  const __m256d zero = _mm256_setzero_pd ();
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+      // the tables are small enough to stay in L1: scalar loads are faster
+      // than the gather instructions on many processors
+      const uint8_t* c = trafficClass + i;
+      const uint8_t* m = mcs + i;
+      __m256d a = _mm256_set_pd (coefficient[c[3]], coefficient[c[2]], coefficient[c[1]], coefficient[c[0]]);
+      __m256d r = _mm256_set_pd (rate[m[3]], rate[m[2]], rate[m[1]], rate[m[0]]);
+      __m256d w = _mm256_div_pd (_mm256_mul_pd (_mm256_mul_pd (a, _mm256_loadu_pd (holDelay + i)), r),
+                                 _mm256_loadu_pd (avgThroughput + i));
+      // null weight (rather than, e.g., 0/0) for the stations with no traffic class
+      int32_t packed;
+      std::memcpy (&packed, c, sizeof (packed));
+      __m128i unknown = _mm_cmpeq_epi32 (_mm_cvtepu8_epi32 (_mm_cvtsi32_si128 (packed)),
+                                         _mm_set1_epi32 (TrafficClassifier::UNKNOWN));
+      _mm256_storeu_pd (weight + i, _mm256_blendv_pd (w, zero, _mm256_castsi256_pd (_mm256_cvtepi32_epi64 (unknown))));
+    }
+  ComputeRange (i, n, trafficClass, mcs, holDelay, avgThroughput, coefficient, rate, weight);
+}
+#endif
+
+} // unnamed namespace
+
+void
+MlwdfWeightKernel::Compute (std::size_t n, const uint8_t* trafficClass, const uint8_t* mcs,
+                            const double* holDelay, const double* avgThroughput,
+                            const StaStateTable::ClassCoefficients& coefficient,
+                            const StaStateTable::McsRates& rate, double* weight)
+{
+#ifdef MLWDF_WEIGHT_KERNEL_AVX2
+  if (IsVectorized ())
+    {
+      ComputeAvx2 (n, trafficClass, mcs, holDelay, avgThroughput, coefficient, rate, weight);
+      return;
+    }
+#endif
+  ComputeRange (0, n, trafficClass, mcs, holDelay, avgThroughput, coefficient, rate, weight);
+}
+
+void
+MlwdfWeightKernel::ComputeScalar (std::size_t n, const uint8_t* trafficClass, const uint8_t* mcs,
+                                  const double* holDelay, const double* avgThroughput,
+                                  const StaStateTable::ClassCoefficients& coefficient,
+                                  const StaStateTable::McsRates& rate, double* weight)
+{
+  ComputeRange (0, n, trafficClass, mcs, holDelay, avgThroughput, coefficient, rate, weight);
+}
+
+bool
+MlwdfWeightKernel::IsVectorized (void)
+{
+#ifdef MLWDF_WEIGHT_KERNEL_AVX2
+  static const bool avx2 = __builtin_cpu_supports ("avx2");
+  return avx2;
+#else
+  return false;
+#endif
+}
+
+} //namespace ns3
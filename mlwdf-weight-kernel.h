@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MLWDF_WEIGHT_KERNEL_H
+#define MLWDF_WEIGHT_KERNEL_H
+
+#include "sta-state-table.h"
+#include <cstddef>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * MlwdfWeightKernel computes the M-LWDF weight a_i * W_i * r_i / R_i of a
+ * batch of stations whose parameters are stored as a struct of arrays (see
+ * StaStateTable), where a_i is the coefficient of the traffic class of the
+ * station, W_i its head-of-line delay, r_i the rate of its MCS and R_i its
+ * served throughput. Stations with no traffic class have a null weight. On
+ * x86 processors supporting AVX2 (checked at run time), four stations are
+ * weighted at a time; the coefficients and rates are looked up in their
+ * tables and the products are evaluated in the same order as in the scalar
+ * loop, so that both produce identical weights.
+ */
+class MlwdfWeightKernel
+{
+public:
+  /**
+   * Compute the weights with the vector loop, if available, or the scalar one.
+   *
+   * \param n the number of stations
+   * \param trafficClass the traffic class of each station
+   * \param mcs the MCS of each station
+   * \param holDelay the head-of-line delay (s) of each station
+   * \param avgThroughput the average throughput (Mb/s) served to each station
+   * \param coefficient the coefficient a_i of each traffic class
+   * \param rate the rate (Mb/s) of each MCS
+   * \param weight the computed weight of each station
+   */
+  static void Compute (std::size_t n, const uint8_t* trafficClass, const uint8_t* mcs,
+                       const double* holDelay, const double* avgThroughput,
+                       const StaStateTable::ClassCoefficients& coefficient,
+                       const StaStateTable::McsRates& rate, double* weight);
+  /**
+   * Compute the weights one station at a time.
+   *
+   * \copydetails Compute
+   */
+  static void ComputeScalar (std::size_t n, const uint8_t* trafficClass, const uint8_t* mcs,
+                             const double* holDelay, const double* avgThroughput,
+                             const StaStateTable::ClassCoefficients& coefficient,
+                             const StaStateTable::McsRates& rate, double* weight);
+  /**
+   * \return true if Compute uses the vector loop on this processor
+   */
+  static bool IsVectorized (void);
+};
+
+} //namespace ns3
+
+#endif /* MLWDF_WEIGHT_KERNEL_H */
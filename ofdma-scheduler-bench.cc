@@ -0,0 +1,848 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "candidate-queue.h"
+#include "mlwdf-ranking.h"
+#include "mlwdf-weight-kernel.h"
+#include "ofdma-scheduler-core.h"
+#include "scheduler-arena.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace ns3;
+
+/**
+ * \brief Microbenchmark of the RrOfdmaManager scheduling steps
+ *
+ * Usage: g++ -O2 -std=c++11 -I. -I$NS3/build -I$NS3/src/wifi/model ofdma-scheduler-bench.cc \
+ *            ofdma-scheduler-core.cc scheduling-policy.cc sta-state-table.cc traffic-classifier.cc \
+ *            ru-pattern-allocator.cc ru-snr-map.cc he-ru-tiling.cc he-rate-table.cc mlwdf-ranking.cc \
+ *            scheduler-arena.cc mlwdf-weight-kernel.cc candidate-queue.cc -L$NS3/build/lib \
+ *            -lns3-wifi -lns3-network -lns3-core -o ofdma-scheduler-bench
+ *        (use the names of the ns-3 libraries found in $NS3/build/lib)
+ *        ./ofdma-scheduler-bench [maxUsers=9] [iterations=20000] [decisions=500] [budgetNs=0] [policy=0]
+ *                                [planCache=0] [fixedPoint=0]
+ *
+ * For an increasing number of associated stations, the per-call cost of ranking
+ * the candidate stations by M-LWDF weight and looking up the selected ones is
+ * reported for the bounded heap of MlwdfRanking and for the insertion sort plus
+ * list walk previously used by RrOfdmaManager::mlwdf().
+ *
+ * The M-LWDF weights of up to 4096 stations with random parameters are then
+ * computed by the vector and the scalar loops of MlwdfWeightKernel: the
+ * per-call cost of both is reported and the exit status is 4 if the weights
+ * differ in any bit.
+ *
+ * Then, for every channel width and 1 to 1024 associated stations, complete DL
+ * OFDMA decisions are taken by OfdmaSchedulerCore (the code run by
+ * RrOfdmaManager) on synthetic queue states: about 80% of the stations are
+ * backlogged, with random traffic class, MCS, head-of-line delay, queued bytes
+ * and served throughput. The cost of refilling the station table and taking a
+ * decision is reported as ns/decision, heap allocations/decision (calls to
+ * operator new) and cache misses/decision (Linux perf events, n/a if they are
+ * not available). Like RrOfdmaManager, every decision resets a SchedulerArena
+ * and lists the selected stations in an arena-backed map. Once the containers
+ * have reached their steady-state capacity, decisions must not allocate from
+ * the heap: otherwise, the exit status is 3. If a budget is given, the exit
+ * status is 2 when a decision takes longer on average, so that the benchmark
+ * can gate scheduler changes.
+ * The scheduling policy is given by its SchedulingPolicyType value (0: M-LWDF).
+ * If planCache is not null, the RU allocations are memoized in a plan cache of
+ * that many entries and the fraction of the measured decisions reusing a plan
+ * is reported as well.
+ * If fixedPoint is not null, the M-LWDF weights are computed in fixed point
+ * (see FixedPointMlwdfPolicy) and a digest of the RUs granted by the measured
+ * decisions is reported. The synthetic inputs do not go through the math
+ * library, so the digest is expected to be the same for every build of the
+ * benchmark (optimization level, floating-point flags) and can be compared to
+ * the digest of a reference build to detect decision changes.
+ *
+ * Finally, the stations selected by CandidateQueue (as with the
+ * BucketedCandidates attribute of RrOfdmaManager) are compared, in floating
+ * and fixed point, with the stations selected by a pass over all the
+ * backlogged stations. The synthetic stations are backlogged for several
+ * TIDs, with a traffic class per TID, and the TID and the AC of the TXOP
+ * change from one TXOP to the next, so that a station is not always served
+ * for the same TID. The exit status is 5 if the selections differ.
+ */
+
+/// Number of calls to operator new
+static std::size_t g_nAllocations = 0;
+
+void*
+operator new (std::size_t size)
+{
+  g_nAllocations++;
+  void* p = std::malloc (size == 0 ? 1 : size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void
+operator delete (void* p) noexcept
+{
+  std::free (p);
+}
+
+namespace {
+
+/// A candidate station, as stored in the list of candidates of RrOfdmaManager
+typedef std::pair<int /* MAC address stand-in */, int /* AID */> Candidate;
+
+/**
+ * Rank the candidates by means of an insertion sort over the weights and walk
+ * the list of candidates from the beginning to retrieve each selected one.
+ */
+std::size_t
+InsertionSortAndWalk (const std::vector<double>& weights, const std::list<Candidate>& candidates,
+                      std::size_t k, std::vector<Candidate>& selected)
+{
+  std::vector<double> key (weights);
+  std::vector<std::size_t> order (weights.size ());
+  for (std::size_t i = 0; i < order.size (); i++)
+    {
+      order[i] = i;
+    }
+  for (std::size_t i = 1; i < key.size (); i++)
+    {
+      double w = key[i];
+      std::size_t idx = order[i];
+      std::size_t j = i;
+      while (j > 0 && key[j - 1] < w)
+        {
+          key[j] = key[j - 1];
+          order[j] = order[j - 1];
+          j--;
+        }
+      key[j] = w;
+      order[j] = idx;
+    }
+
+  selected.clear ();
+  for (std::size_t r = 0; r < std::min (k, order.size ()); r++)
+    {
+      auto it = candidates.begin ();
+      std::advance (it, order[r]);
+      selected.push_back (*it);
+    }
+  return selected.size ();
+}
+
+/**
+ * Rank the candidates by means of MlwdfRanking and retrieve each selected one
+ * by index.
+ */
+std::size_t
+TopKAndIndex (MlwdfRanking& ranking, const std::vector<double>& weights,
+              const std::vector<Candidate>& candidates, std::size_t k, std::vector<Candidate>& selected)
+{
+  selected.clear ();
+  for (auto i : ranking.SelectTopK (weights, k))
+    {
+      selected.push_back (candidates[i]);
+    }
+  return selected.size ();
+}
+
+/**
+ * \return the average duration in nanoseconds of a call to the given function
+ */
+template <typename F>
+double
+NsPerCall (F f, std::size_t iterations)
+{
+  auto start = std::chrono::steady_clock::now ();
+  for (std::size_t i = 0; i < iterations; i++)
+    {
+      f ();
+    }
+  auto stop = std::chrono::steady_clock::now ();
+  return std::chrono::duration<double, std::nano> (stop - start).count () / iterations;
+}
+
+/**
+ * Counter of the cache misses of the calling thread (user space only), based
+ * on the Linux perf events.
+ */
+class CacheMissCounter
+{
+public:
+  CacheMissCounter ()
+    : m_fd (-1)
+  {
+#ifdef __linux__
+    perf_event_attr attr;
+    std::memset (&attr, 0, sizeof (attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof (attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    m_fd = static_cast<int> (syscall (__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+  ~CacheMissCounter ()
+  {
+#ifdef __linux__
+    if (m_fd >= 0)
+      {
+        close (m_fd);
+      }
+#endif
+  }
+  /// \return true if cache misses can be counted
+  bool IsAvailable (void) const
+  {
+    return m_fd >= 0;
+  }
+  /// Reset and start the counter
+  void Start (void)
+  {
+#ifdef __linux__
+    if (m_fd >= 0)
+      {
+        ioctl (m_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl (m_fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+#endif
+  }
+  /// \return the cache misses counted since the last call to Start
+  uint64_t Stop (void)
+  {
+    uint64_t count = 0;
+#ifdef __linux__
+    if (m_fd >= 0)
+      {
+        ioctl (m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read (m_fd, &count, sizeof (count)) != sizeof (count))
+          {
+            count = 0;
+          }
+      }
+#endif
+    return count;
+  }
+
+private:
+  int m_fd;  //!< the perf event file descriptor
+};
+
+/// The state of a backlogged station in a synthetic queue state
+struct SyntheticStation
+{
+  uint16_t aid;             //!< the AID
+  uint8_t trafficClass;     //!< the traffic class
+  uint8_t mcs;              //!< the MCS
+  uint32_t bytes;           //!< the queued bytes
+  int64_t holAge;           //!< the age (ns) of the head-of-line frame
+  double throughput;        //!< the served throughput (Mb/s)
+};
+
+/**
+ * Generate synthetic queue states for the given number of stations.
+ *
+ * \param nStations the number of associated stations
+ * \param nStates the number of queue states
+ * \param rng the random number generator
+ * \return the backlogged stations of each queue state
+ */
+std::vector<std::vector<SyntheticStation>>
+GenerateQueueStates (std::size_t nStations, std::size_t nStates, std::mt19937& rng)
+{
+  std::bernoulli_distribution backlogged (0.8);
+  std::uniform_int_distribution<int> trafficClass (1, TrafficClassifier::N_CLASSES);
+  std::uniform_int_distribution<int> mcs (0, HeRateTable::N_MCS - 1);
+  std::uniform_int_distribution<uint32_t> bytes (100, 200000);
+  std::uniform_int_distribution<int64_t> holAge (0, 50000000);
+  std::uniform_real_distribution<double> throughput (0.001, 100.0);
+
+  std::vector<std::vector<SyntheticStation>> states (nStates);
+  for (auto& state : states)
+    {
+      for (std::size_t i = 0; i < nStations; i++)
+        {
+          // at least one station is always backlogged
+          if (backlogged (rng) || (i + 1 == nStations && state.empty ()))
+            {
+              state.push_back ({static_cast<uint16_t> (i + 1), static_cast<uint8_t> (trafficClass (rng)),
+                                static_cast<uint8_t> (mcs (rng)), bytes (rng), holAge (rng), throughput (rng)});
+            }
+        }
+    }
+  return states;
+}
+
+/// Per-decision cost measured by RunDecisions
+struct DecisionCost
+{
+  double ns;                //!< nanoseconds per decision
+  double allocations;       //!< calls to operator new per decision
+  double cacheMisses;       //!< cache misses per decision (negative if not available)
+  double planHits;          //!< fraction of the allocations reusing a memoized plan
+  uint64_t digest;          //!< FNV-1a digest of the RUs granted by the measured decisions
+};
+
+/// The TID of the selected stations, indexed by AID, held in the scratch arena
+typedef std::map<uint16_t, uint8_t, std::less<uint16_t>,
+                 ArenaAllocator<std::pair<const uint16_t, uint8_t>>> ScratchStaList;
+
+/**
+ * Refill the station table with the given queue state and take a decision.
+ *
+ * \param core the scheduling core
+ * \param table the station table
+ * \param arena the scratch arena of the scheduling cycle
+ * \param state the queue state
+ * \param now the current time (ns)
+ * \param maxUsers the maximum number of stations that can be granted an RU
+ * \return the number of stations granted an RU
+ */
+std::size_t
+Decide (OfdmaSchedulerCore& core, StaStateTable& table, SchedulerArena& arena,
+        const std::vector<SyntheticStation>& state, int64_t now, std::size_t maxUsers)
+{
+  arena.Reset ();
+  table.ClearCandidates ();
+  for (auto& sta : state)
+    {
+      table.AddCandidate (sta.aid, Mac48Address (), 0, sta.bytes, sta.trafficClass, sta.mcs,
+                          now - sta.holAge, sta.throughput);
+    }
+  core.Schedule (table, now, 5484000 /* max HE PPDU duration */, maxUsers);
+
+  ScratchStaList receivers {ArenaAllocator<ScratchStaList::value_type> (arena)};
+  for (auto aid : table.GetAllocated ())
+    {
+      receivers[aid] = table.GetTid (aid);
+    }
+  return receivers.size ();
+}
+
+/**
+ * Measure the cost of the scheduling decisions for the given queue states.
+ *
+ * \param width the channel width
+ * \param policy the scheduling policy
+ * \param nStations the number of associated stations
+ * \param states the queue states, used in turn
+ * \param decisions the number of measured decisions
+ * \param maxUsers the maximum number of stations that can be granted an RU
+ * \param planCache the number of entries of the plan cache (0 to disable it)
+ * \param fixedPoint whether the M-LWDF weights are computed in fixed point
+ * \param cacheMisses the cache miss counter
+ * \param sink accumulates the number of granted RUs
+ * \return the per-decision cost
+ */
+DecisionCost
+RunDecisions (uint16_t width, SchedulingPolicyType policy, std::size_t nStations, const std::vector<std::vector<SyntheticStation>>& states,
+              std::size_t decisions, std::size_t maxUsers, std::size_t planCache, bool fixedPoint,
+              CacheMissCounter& cacheMisses, std::size_t& sink)
+{
+  OfdmaSchedulerCore core;
+  core.SetChannel (width, 800);
+  core.SetPolicy (policy);
+  core.SetPlanCache (planCache, maxUsers);
+  core.SetFixedPoint (fixedPoint);
+  StaStateTable table;
+  SchedulerArena arena;
+  for (std::size_t i = 1; i <= nStations; i++)
+    {
+      table.NotifyAssociation (static_cast<uint16_t> (i), Mac48Address ());
+    }
+
+  // warm up: let the containers reach their steady-state capacity
+  int64_t now = 100000000;
+  for (std::size_t d = 0; d < states.size (); d++, now += 1000000)
+    {
+      sink += Decide (core, table, arena, states[d], now, maxUsers);
+    }
+
+  std::size_t allocations = g_nAllocations;
+  uint64_t hits = core.GetAllocator ().GetPlanCacheHits ();
+  uint64_t lookups = hits + core.GetAllocator ().GetPlanCacheMisses ();
+  cacheMisses.Start ();
+  auto start = std::chrono::steady_clock::now ();
+  uint64_t digest = 14695981039346656037ULL;
+  for (std::size_t d = 0; d < decisions; d++, now += 1000000)
+    {
+      sink += Decide (core, table, arena, states[d % states.size ()], now, maxUsers);
+      for (auto aid : table.GetAllocated ())
+        {
+          const HeRu::RuSpec& ru = table.GetRu (aid);
+          for (uint64_t value : {static_cast<uint64_t> (aid), static_cast<uint64_t> (ru.ruType),
+                                 static_cast<uint64_t> (ru.index), static_cast<uint64_t> (ru.primary80MHz)})
+            {
+              digest = (digest ^ value) * 1099511628211ULL;
+            }
+        }
+    }
+  auto stop = std::chrono::steady_clock::now ();
+  uint64_t misses = cacheMisses.Stop ();
+  allocations = g_nAllocations - allocations;
+  hits = core.GetAllocator ().GetPlanCacheHits () - hits;
+  lookups = core.GetAllocator ().GetPlanCacheHits () + core.GetAllocator ().GetPlanCacheMisses () - lookups;
+
+  return {std::chrono::duration<double, std::nano> (stop - start).count () / decisions,
+          static_cast<double> (allocations) / decisions,
+          cacheMisses.IsAvailable () ? static_cast<double> (misses) / decisions : -1.0,
+          lookups > 0 ? static_cast<double> (hits) / lookups : 0.0,
+          digest};
+}
+
+/// The AC of each TID, numbered as the ns-3 AcIndex values (AC_BE = 0, AC_BK, AC_VI, AC_VO)
+const std::array<uint8_t, 8> TID_TO_AC = {{0, 1, 1, 0, 2, 2, 3, 3}};
+
+/// The state of a station in the check of the bucketed selection
+struct BucketedStation
+{
+  uint8_t traffic;                    //!< bitmap of the TIDs the station receives frames for
+  uint8_t tids;                       //!< bitmap of the backlogged TIDs
+  uint8_t agreements;                 //!< bitmap of the TIDs with a Block Ack agreement
+  std::array<int64_t, 8> holTimestamp; //!< the timestamp (ns) of the HOL frame of each TID
+  uint8_t mcs;                        //!< the MCS
+  double bps;                         //!< the served throughput (bit/s) at the last update
+  double lastUpdate;                  //!< the time (s) of the last update
+};
+
+/**
+ * Take scheduling decisions on synthetic multi-TID stations, selecting the
+ * candidates with CandidateQueue as RrOfdmaManager does, and count the
+ * decisions whose selected stations differ from those of a pass over all the
+ * backlogged stations.
+ *
+ * \param fixedPoint whether the M-LWDF weights are computed in fixed point
+ * \param maxUsers the maximum number of stations that can be granted an RU
+ * \param rng the random number generator
+ * \param examined set to the average number of stations examined per decision
+ * \return the number of decisions whose selected stations differ
+ */
+std::size_t
+CheckBucketedSelection (bool fixedPoint, std::size_t maxUsers, std::mt19937& rng, double& examined)
+{
+  const std::size_t nStations = 300;
+  const std::size_t nDecisions = 20000;
+  const uint16_t width = 80;
+  const double tau = 0.1;                 // time constant (s) of the served throughput
+  const int64_t horizon = 5000000;
+  const std::array<uint8_t, 8> tidClass = {{2, 1, 1, 2, 3, 3, 4, 4}};
+
+  std::array<double, HeRateTable::N_MCS> rate;
+  for (uint8_t mcs = 0; mcs < HeRateTable::N_MCS; mcs++)
+    {
+      rate[mcs] = HeRateTable::GetRateKbps (mcs, width, 800,
+                                            HeRateTable::GetRuIndex (HeRateTable::GetFullBandRuTones (width))) / 1e3;
+    }
+  std::vector<BucketedStation> stations (nStations + 1, BucketedStation {0, 0, 0xff, {{}}, HeRateTable::N_MCS - 1, 0.0, 0.0});
+  auto throughput = [&] (uint16_t aid, int64_t now)
+    {
+      const BucketedStation& sta = stations[aid];
+      return std::max (sta.bps * std::exp ((sta.lastUpdate - now * 1e-9) / tau), 1e3) / 1e6;
+    };
+
+  // every station receives frames for one or two TIDs
+  for (auto& sta : stations)
+    {
+      sta.traffic = (1 << (rng () % 8)) | (rng () % 2 == 0 ? 1 << (rng () % 8) : 0);
+    }
+
+  CandidateQueue queue;
+  queue.SetHorizon (horizon, std::exp (horizon * 1e-9 / tau));
+  queue.SetWeights (fixedPoint, rate[HeRateTable::N_MCS - 1]);
+
+  std::size_t mismatches = 0;
+  std::size_t pops = 0;
+  int64_t now = 0;
+  std::vector<uint8_t> servedTid (nStations + 1);
+  std::vector<double> weight (nStations + 1);
+  std::vector<uint64_t> fixedWeight (nStations + 1);
+  std::vector<uint16_t> reference;
+  std::vector<uint16_t> selected;
+  std::vector<uint16_t> popped;
+  for (std::size_t d = 0; d < nDecisions; d++)
+    {
+      now += 100000 + rng () % 2000000;
+
+      // new frames, some of them older than the HOL frame (retransmissions);
+      // as RrOfdmaManager, the stations whose bound does not cover the frame
+      // are invalidated
+      for (int i = 0; i < 3; i++)
+        {
+          uint16_t aid = static_cast<uint16_t> (1 + rng () % nStations);
+          BucketedStation& sta = stations[aid];
+          uint8_t tid = rng () % 8;
+          while ((sta.traffic & (1 << tid)) == 0)
+            {
+              tid = rng () % 8;
+            }
+          int64_t timestamp = (rng () % 16 == 0 ? now - static_cast<int64_t> (rng () % 30000000) : now);
+          if ((sta.tids & (1 << tid)) == 0 || !queue.IsQueued (aid) || timestamp < now)
+            {
+              queue.Invalidate (aid);
+            }
+          sta.holTimestamp[tid] = ((sta.tids & (1 << tid)) == 0 ? timestamp
+                                   : std::min (sta.holTimestamp[tid], timestamp));
+          sta.tids |= (1 << tid);
+        }
+      for (uint16_t aid = 1; aid <= nStations; aid++)
+        {
+          if (rng () % 50 == 0)
+            {
+              stations[aid].mcs = HeRateTable::N_MCS - 1 - rng () % 3;
+            }
+        }
+      // a Block Ack agreement is torn down or established from time to time
+      stations[1 + rng () % nStations].agreements ^= (1 << (rng () % 8));
+      stations[1 + rng () % nStations].agreements = 0xff;
+
+      // the TID of the frame that won the TXOP (mostly a BE frame), hence the
+      // TID tried first and the primary AC, change from one TXOP to the next
+      uint8_t currTid = (rng () % 4 == 0 ? rng () % 8 : 0);
+      uint8_t primaryAc = TID_TO_AC[currTid];
+      auto evaluate = [&] (uint16_t aid)
+        {
+          const BucketedStation& sta = stations[aid];
+          for (uint8_t tid : {currTid, uint8_t (1), uint8_t (2), uint8_t (0), uint8_t (3), uint8_t (4),
+                              uint8_t (5), uint8_t (6), uint8_t (7)})
+            {
+              if ((sta.tids & sta.agreements & (1 << tid)) != 0 && TID_TO_AC[tid] >= primaryAc)
+                {
+                  double holDelay = StaStateTable::GetHolDelay (now, sta.holTimestamp[tid]);
+                  servedTid[aid] = tid;
+                  weight[aid] = MlwdfPolicy ().DoWeight (tidClass[tid], holDelay, rate[sta.mcs],
+                                                         throughput (aid, now), 0);
+                  fixedWeight[aid] = FixedPointMlwdfPolicy::FixedWeight (tidClass[tid], holDelay, rate[sta.mcs],
+                                                                         throughput (aid, now));
+                  return true;
+                }
+            }
+          return false;
+        };
+      // the stations granted an RU by the core among the given candidates
+      auto rank = [&] (std::vector<uint16_t>& candidates)
+        {
+          uint64_t largest = 0;
+          for (auto aid : candidates)
+            {
+              largest = std::max (largest, fixedWeight[aid]);
+            }
+          unsigned shift = FixedPointMlwdfPolicy::GetShift (largest);
+          auto key = [&] (uint16_t aid)
+            {
+              return (fixedPoint ? static_cast<double> (FixedPointMlwdfPolicy::Normalize (fixedWeight[aid], shift))
+                                 : weight[aid]);
+            };
+          std::sort (candidates.begin (), candidates.end (), [&] (uint16_t a, uint16_t b)
+                     { return key (a) > key (b) || (key (a) == key (b) && a < b); });
+          candidates.resize (std::min (candidates.size (), maxUsers));
+        };
+
+      reference.clear ();
+      for (uint16_t aid = 1; aid <= nStations; aid++)
+        {
+          if (evaluate (aid))
+            {
+              reference.push_back (aid);
+            }
+        }
+      rank (reference);
+
+      selected.clear ();
+      popped.clear ();
+      if (queue.NeedsRebuild (now))
+        {
+          for (uint16_t aid = 1; aid <= nStations; aid++)
+            {
+              if (stations[aid].tids != 0)
+                {
+                  popped.push_back (aid);
+                  if (evaluate (aid))
+                    {
+                      selected.push_back (aid);
+                    }
+                }
+            }
+          queue.Reset (now);
+        }
+      else
+        {
+          queue.StartSelection (maxUsers);
+          while (!queue.IsSelectionDone ())
+            {
+              uint16_t aid = queue.Pop ();
+              popped.push_back (aid);
+              if (evaluate (aid))
+                {
+                  selected.push_back (aid);
+                  queue.AddSelected (tidClass[servedTid[aid]],
+                                     StaStateTable::GetHolDelay (now, stations[aid].holTimestamp[servedTid[aid]]),
+                                     rate[stations[aid].mcs], throughput (aid, now));
+                }
+            }
+        }
+      pops += popped.size ();
+      rank (selected);
+      mismatches += (selected != reference);
+
+      // queue the examined stations again with the largest bound of their TIDs
+      for (auto aid : popped)
+        {
+          const BucketedStation& sta = stations[aid];
+          uint8_t boundClass = TrafficClassifier::UNKNOWN;
+          double bound = 0;
+          for (uint8_t tid = 0; tid < 8; tid++)
+            {
+              if ((sta.tids & (1 << tid)) == 0)
+                {
+                  continue;
+                }
+              double tidBound = queue.GetBound (tidClass[tid], sta.holTimestamp[tid], throughput (aid, now));
+              if (boundClass == TrafficClassifier::UNKNOWN || tidBound > bound)
+                {
+                  boundClass = tidClass[tid];
+                  bound = tidBound;
+                }
+            }
+          if (boundClass != TrafficClassifier::UNKNOWN)
+            {
+              queue.Push (aid, boundClass, bound);
+            }
+        }
+
+      // serve the selected stations for the TID they were selected for
+      for (auto aid : selected)
+        {
+          BucketedStation& sta = stations[aid];
+          sta.bps = sta.bps * std::exp ((sta.lastUpdate - now * 1e-9) / tau) + 8.0 * 3000 / tau;
+          sta.lastUpdate = now * 1e-9;
+          if (rng () % 3 == 0)
+            {
+              sta.tids &= ~(1 << servedTid[aid]);
+            }
+          else
+            {
+              // the next frame is not older than the frames sent
+              int64_t& holTimestamp = sta.holTimestamp[servedTid[aid]];
+              holTimestamp += static_cast<int64_t> (rng () % static_cast<uint64_t> (now - holTimestamp + 1));
+            }
+        }
+    }
+  examined = static_cast<double> (pops) / nDecisions;
+  return mismatches;
+}
+
+} // unnamed namespace
+
+int
+main (int argc, char *argv[])
+{
+  std::size_t k = (argc > 1 ? std::strtoul (argv[1], 0, 10) : 9);
+  std::size_t iterations = (argc > 2 ? std::strtoul (argv[2], 0, 10) : 20000);
+  std::size_t decisions = (argc > 3 ? std::strtoul (argv[3], 0, 10) : 500);
+  double budget = (argc > 4 ? std::strtod (argv[4], 0) : 0.0);
+  auto policy = static_cast<SchedulingPolicyType> (argc > 5 ? std::atoi (argv[5]) : MLWDF_POLICY);
+  std::size_t planCache = (argc > 6 ? std::strtoul (argv[6], 0, 10) : 0);
+  bool fixedPoint = (argc > 7 && std::atoi (argv[7]) != 0);
+
+  std::mt19937 rng (1);
+  std::uniform_real_distribution<double> weightDist (0.0, 1e6);
+  MlwdfRanking ranking;
+  std::vector<Candidate> selected;
+  selected.reserve (k);
+  std::size_t sink = 0;
+
+  std::cout << "Ranking the top " << k << " candidates (ns/call)" << std::endl
+            << "--------------------------------------------" << std::endl
+            << std::setw (10) << "stations" << std::setw (16) << "insertion+walk"
+            << std::setw (16) << "top-K+index" << std::endl;
+
+  for (std::size_t n = 8; n <= 1024; n *= 2)
+    {
+      std::vector<double> weights (n);
+      std::vector<Candidate> candidateVector;
+      std::list<Candidate> candidateList;
+      for (std::size_t i = 0; i < n; i++)
+        {
+          weights[i] = weightDist (rng);
+          candidateVector.push_back (std::make_pair (static_cast<int> (i), static_cast<int> (i + 1)));
+          candidateList.push_back (candidateVector.back ());
+        }
+
+      // the quadratic baseline gets too slow for large numbers of stations
+      std::size_t baselineIterations = std::max<std::size_t> (1, iterations * 8 / n / n * 8);
+      double baseline = NsPerCall ([&] () { sink += InsertionSortAndWalk (weights, candidateList, k, selected); },
+                                   baselineIterations);
+      double topK = NsPerCall ([&] () { sink += TopKAndIndex (ranking, weights, candidateVector, k, selected); },
+                               iterations);
+
+      std::cout << std::setw (10) << n << std::fixed << std::setprecision (1)
+                << std::setw (16) << baseline << std::setw (16) << topK << std::endl;
+    }
+
+  std::cout << std::endl << "M-LWDF weights (ns/call), vector loop "
+            << (MlwdfWeightKernel::IsVectorized () ? "available" : "not available") << std::endl
+            << "--------------------------------------------" << std::endl
+            << std::setw (10) << "stations" << std::setw (16) << "scalar" << std::setw (16) << "vector" << std::endl;
+
+  bool mismatch = false;
+  std::uniform_int_distribution<int> classDist (0, TrafficClassifier::N_CLASSES);
+  std::uniform_int_distribution<int> mcsDist (0, HeRateTable::N_MCS - 1);
+  std::uniform_real_distribution<double> delayDist (1e-9, 1.0);
+  std::uniform_real_distribution<double> throughputDist (0.1, 100.0);
+  StaStateTable::McsRates rates;
+  for (uint8_t mcs = 0; mcs < HeRateTable::N_MCS; mcs++)
+    {
+      rates[mcs] = HeRateTable::GetRateKbps (mcs, 20, 800, HeRateTable::GetRuIndex (242)) / 1e3;
+    }
+
+  // odd sizes exercise the scalar tail of the vector loop
+  for (std::size_t n : {63, 256, 1023, 4096})
+    {
+      std::vector<uint8_t> trafficClass (n);
+      std::vector<uint8_t> mcs (n);
+      std::vector<double> holDelay (n);
+      std::vector<double> avgThroughput (n);
+      for (std::size_t i = 0; i < n; i++)
+        {
+          trafficClass[i] = static_cast<uint8_t> (classDist (rng));
+          mcs[i] = static_cast<uint8_t> (mcsDist (rng));
+          holDelay[i] = delayDist (rng);
+          // non-candidates may have no served throughput yet
+          avgThroughput[i] = (trafficClass[i] == TrafficClassifier::UNKNOWN ? 0.0 : throughputDist (rng));
+        }
+      std::vector<double> scalar (n);
+      std::vector<double> vectorized (n);
+
+      double scalarNs = NsPerCall ([&] () { MlwdfWeightKernel::ComputeScalar (n, trafficClass.data (), mcs.data (), holDelay.data (),
+                                                                               avgThroughput.data (), MlwdfPolicy::COEFFICIENT,
+                                                                               rates, scalar.data ()); },
+                                   iterations / 16 + 1);
+      double vectorNs = NsPerCall ([&] () { MlwdfWeightKernel::Compute (n, trafficClass.data (), mcs.data (), holDelay.data (),
+                                                                         avgThroughput.data (), MlwdfPolicy::COEFFICIENT,
+                                                                         rates, vectorized.data ()); },
+                                   iterations / 16 + 1);
+      bool equal = (std::memcmp (scalar.data (), vectorized.data (), n * sizeof (double)) == 0);
+      mismatch = mismatch || !equal;
+      sink += static_cast<std::size_t> (scalar[n / 2] + vectorized[n / 2]);
+
+      std::cout << std::setw (10) << n << std::fixed << std::setprecision (1)
+                << std::setw (16) << scalarNs << std::setw (16) << vectorNs
+                << (equal ? "" : "  weights differ") << std::endl;
+    }
+
+  std::cout << std::endl << "Scheduling decisions, up to " << k << " users per PPDU" << std::endl
+            << "--------------------------------------------" << std::endl
+            << std::setw (8) << "width" << std::setw (10) << "stations" << std::setw (14) << "ns/decision"
+            << std::setw (14) << "allocs/dec" << std::setw (14) << "misses/dec"
+            << (planCache > 0 ? "     plan hits" : "") << (fixedPoint ? "            digest" : "") << std::endl;
+
+  CacheMissCounter cacheMisses;
+  bool overBudget = false;
+  bool allocates = false;
+
+  for (uint16_t width : {20, 40, 80, 160})
+    {
+      for (std::size_t n = 1; n <= 1024; n *= 2)
+        {
+          auto states = GenerateQueueStates (n, 16, rng);
+          DecisionCost cost = RunDecisions (width, policy, n, states, decisions, k, planCache, fixedPoint,
+                                           cacheMisses, sink);
+          overBudget = overBudget || (budget > 0 && cost.ns > budget);
+          allocates = allocates || cost.allocations > 0;
+
+          std::cout << std::setw (8) << width << std::setw (10) << n << std::fixed << std::setprecision (1)
+                    << std::setw (14) << cost.ns << std::setw (14) << cost.allocations;
+          if (cost.cacheMisses >= 0)
+            {
+              std::cout << std::setw (14) << cost.cacheMisses;
+            }
+          else
+            {
+              std::cout << std::setw (14) << "n/a";
+            }
+          if (planCache > 0)
+            {
+              std::cout << std::setw (13) << 100 * cost.planHits << "%";
+            }
+          if (fixedPoint)
+            {
+              std::cout << "  " << std::hex << std::setfill ('0') << std::setw (16) << cost.digest
+                        << std::dec << std::setfill (' ');
+            }
+          std::cout << (budget > 0 && cost.ns > budget ? "  over budget" : "") << std::endl;
+        }
+    }
+
+  std::cout << std::endl << "Bucketed candidate selection, 300 stations, up to " << k << " users per PPDU" << std::endl
+            << "--------------------------------------------" << std::endl
+            << std::setw (8) << "weights" << std::setw (14) << "examined/dec" << std::setw (14) << "mismatches" << std::endl;
+
+  bool selectionDiffers = false;
+  for (bool fixed : {false, true})
+    {
+      double examined;
+      std::size_t mismatches = CheckBucketedSelection (fixed, k, rng, examined);
+      selectionDiffers = selectionDiffers || mismatches > 0;
+      std::cout << std::setw (8) << (fixed ? "fixed" : "float") << std::fixed << std::setprecision (1)
+                << std::setw (14) << examined << std::setw (14) << mismatches << std::endl;
+    }
+
+  if (selectionDiffers)
+    {
+      std::cout << "The bucketed selection differs from a pass over all the stations" << std::endl;
+      return 5;
+    }
+  if (mismatch)
+    {
+      std::cout << "The vector and scalar M-LWDF weights differ" << std::endl;
+      return 4;
+    }
+  if (allocates)
+    {
+      std::cout << "Steady-state decisions allocate from the heap" << std::endl;
+      return 3;
+    }
+  if (overBudget)
+    {
+      return 2;
+    }
+  // prevent the compiler from optimizing the benchmarked calls away
+  return (sink == 0 ? 1 : 0);
+}
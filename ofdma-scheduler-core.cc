@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "ofdma-scheduler-core.h"
+#include <algorithm>
+
+namespace ns3 {
+
+OfdmaSchedulerCore::OfdmaSchedulerCore ()
+  : m_tilings (0),
+    m_guardInterval (0),
+    m_rate {},
+    m_policy (MLWDF_POLICY),
+    m_fixedPoint (false),
+    m_snrMap (0)
+{
+}
+
+void
+OfdmaSchedulerCore::SetChannel (uint16_t width, uint16_t guardInterval)
+{
+  if (m_tilings != 0 && m_tilings->GetChannelWidth () == width && m_guardInterval == guardInterval)
+    {
+      return;
+    }
+  m_tilings = &HeRuTiling::Get (width);
+  m_guardInterval = guardInterval;
+
+  uint8_t fullBandRu = HeRateTable::GetRuIndex (HeRateTable::GetFullBandRuTones (width));
+  for (uint8_t mcs = 0; mcs < HeRateTable::N_MCS; mcs++)
+    {
+      m_rate[mcs] = HeRateTable::GetRateKbps (mcs, width, guardInterval, fullBandRu) / 1e3;
+    }
+}
+
+void
+OfdmaSchedulerCore::SetPolicy (SchedulingPolicyType policy)
+{
+  m_policy = policy;
+}
+
+SchedulingPolicyType
+OfdmaSchedulerCore::GetPolicy (void) const
+{
+  return m_policy;
+}
+
+void
+OfdmaSchedulerCore::SetFixedPoint (bool enable)
+{
+  m_fixedPoint = enable;
+}
+
+void
+OfdmaSchedulerCore::SetSnrMap (const RuSnrMap* snrMap)
+{
+  m_snrMap = snrMap;
+}
+
+void
+OfdmaSchedulerCore::SetPlanCache (std::size_t nEntries, std::size_t maxUsers)
+{
+  m_ruAllocator.SetPlanCache (nEntries, maxUsers);
+}
+
+double
+OfdmaSchedulerCore::Schedule (StaStateTable& table, int64_t now, uint64_t durationNs, std::size_t maxUsers)
+{
+  NS_ASSERT_MSG (m_tilings != 0, "The channel has not been set");
+
+  // the policy is selected once per decision, the weights are computed by a
+  // loop instantiated for each policy
+  switch (m_policy)
+    {
+    case MLWDF_POLICY:
+      if (m_fixedPoint)
+        {
+          table.ComputeWeights (m_mlwdfFixed, m_rate, now);
+        }
+      else
+        {
+          table.ComputeWeights (m_mlwdf, m_rate, now);
+        }
+      break;
+    case PF_POLICY:
+      table.ComputeWeights (m_pf, m_rate, now);
+      break;
+    case EXP_PF_POLICY:
+      table.ComputeWeights (m_expPf, m_rate, now);
+      break;
+    case EDF_POLICY:
+      table.ComputeWeights (m_edf, m_rate, now);
+      break;
+    case MAX_WEIGHT_POLICY:
+      table.ComputeWeights (m_maxWeight, m_rate, now);
+      break;
+    default:
+      NS_ASSERT_MSG (false, "Unknown scheduling policy " << m_policy);
+    }
+
+  // the RU allocator only considers the stations with the largest weights. The
+  // weights are indexed by AID and only the candidates have a non-null weight
+  const std::vector<double>& weights = table.GetWeights ();
+  const std::vector<std::size_t>& ranked =
+    m_ranking.SelectTopK (weights, std::min (table.GetCandidates ().size (), maxUsers));
+
+  m_rankedWeight.clear ();
+  m_rankedMcs.clear ();
+  m_rankedBytes.clear ();
+  for (auto aid : ranked)
+    {
+      m_rankedWeight.push_back (weights[aid]);
+      m_rankedMcs.push_back (table.GetMcs (aid));
+      m_rankedBytes.push_back (table.GetBacklog (aid));
+    }
+
+  double value = m_ruAllocator.Allocate (m_rankedWeight, m_rankedMcs, m_rankedBytes, *m_tilings,
+                                         m_guardInterval, durationNs, maxUsers);
+
+  if (m_snrMap != 0 && value >= 0)
+    {
+      m_rankedSnr.resize (ranked.size () * RuSnrMap::MAX_POSITIONS);
+      bool known = false;
+      for (std::size_t k = 0; k < ranked.size (); k++)
+        {
+          known |= m_snrMap->GetSnr (static_cast<uint16_t> (ranked[k]), now, &m_rankedSnr[k * RuSnrMap::MAX_POSITIONS]);
+        }
+      if (known)
+        {
+          m_ruAllocator.PlaceBySnr (m_rankedWeight, m_rankedSnr, RuSnrMap::MAX_POSITIONS, *m_tilings);
+        }
+    }
+
+  // the assignment is sorted by decreasing RU size
+  for (auto& assignment : m_ruAllocator.GetAssignment ())
+    {
+      table.SetRu (static_cast<uint16_t> (ranked[assignment.candidate]), assignment.ru);
+    }
+  return value;
+}
+
+const RuPatternAllocator&
+OfdmaSchedulerCore::GetAllocator (void) const
+{
+  return m_ruAllocator;
+}
+
+} //namespace ns3
@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef OFDMA_SCHEDULER_CORE_H
+#define OFDMA_SCHEDULER_CORE_H
+
+#include "he-ru-tiling.h"
+#include "mlwdf-ranking.h"
+#include "ru-pattern-allocator.h"
+#include "ru-snr-map.h"
+#include "scheduling-policy.h"
+#include "sta-state-table.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * OfdmaSchedulerCore takes a DL OFDMA scheduling decision given the state of
+ * the candidate stations in a StaStateTable: it computes the weights according
+ * to the selected scheduling policy (M-LWDF by default), ranks the candidates
+ * and selects the RU pattern and the RU of each selected station, which are
+ * stored in the table. If an SNR map is set, the RUs are then moved to the
+ * positions where the selected stations have the best SNR. In fixed-point
+ * mode, the M-LWDF weights are integers computed by FixedPointMlwdfPolicy from
+ * rounded inputs. It does not depend on the simulator, so that RrOfdmaManager
+ * and ofdma-scheduler-bench.cc run the same code.
+ */
+class OfdmaSchedulerCore
+{
+public:
+  OfdmaSchedulerCore ();
+
+  /**
+   * Set the channel the decisions are taken for.
+   *
+   * \param width the channel width in MHz
+   * \param guardInterval the guard interval in nanoseconds
+   */
+  void SetChannel (uint16_t width, uint16_t guardInterval);
+  /**
+   * Set the policy used to weight the candidate stations.
+   *
+   * \param policy the scheduling policy
+   */
+  void SetPolicy (SchedulingPolicyType policy);
+  /**
+   * \return the policy used to weight the candidate stations
+   */
+  SchedulingPolicyType GetPolicy (void) const;
+  /**
+   * Enable or disable the fixed-point mode, in which the M-LWDF weights are
+   * computed by FixedPointMlwdfPolicy.
+   *
+   * \param enable true to compute the M-LWDF weights in fixed point
+   */
+  void SetFixedPoint (bool enable);
+  /**
+   * Set the SNR map used to place the RUs in the channel (see
+   * RuPatternAllocator::PlaceBySnr). The map must outlive the decisions.
+   *
+   * \param snrMap the SNR map, or a null pointer to place the RUs regardless of the SNR
+   */
+  void SetSnrMap (const RuSnrMap* snrMap);
+  /**
+   * Enable or disable the memoization of the RU allocations (see
+   * RuPatternAllocator::SetPlanCache).
+   *
+   * \param nEntries the number of plans the cache can hold (0 disables the cache)
+   * \param maxUsers the largest number of stations that can be granted an RU
+   */
+  void SetPlanCache (std::size_t nEntries, std::size_t maxUsers);
+  /**
+   * Take a scheduling decision for the candidates in the given table.
+   *
+   * \param table the state of the stations, updated with the weights and the granted RUs
+   * \param now the current time (ns)
+   * \param durationNs the time available to transmit the Data field of the PPDU
+   * \param maxUsers the maximum number of stations that can be granted an RU
+   * \return the value of the RU allocation, or a negative value if no RU was granted
+   */
+  double Schedule (StaStateTable& table, int64_t now, uint64_t durationNs, std::size_t maxUsers);
+  /**
+   * \return the RU allocator, holding the details of the last decision
+   */
+  const RuPatternAllocator& GetAllocator (void) const;
+
+private:
+  const HeRuTiling* m_tilings;                  //!< the tilings of the channel
+  uint16_t m_guardInterval;                     //!< the guard interval
+  StaStateTable::McsRates m_rate;               //!< full-band rate (Mb/s) of each MCS
+  SchedulingPolicyType m_policy;                //!< the selected scheduling policy
+  MlwdfPolicy m_mlwdf;                          //!< the M-LWDF policy
+  FixedPointMlwdfPolicy m_mlwdfFixed;           //!< the M-LWDF policy in fixed point
+  bool m_fixedPoint;                            //!< whether M-LWDF is computed in fixed point
+  PfPolicy m_pf;                                //!< the proportional fair policy
+  ExpPfPolicy m_expPf;                          //!< the EXP/PF policy
+  EdfPolicy m_edf;                              //!< the earliest deadline first policy
+  MaxWeightPolicy m_maxWeight;                  //!< the max-weight policy
+  MlwdfRanking m_ranking;                       //!< selects the candidates with the largest weights
+  RuPatternAllocator m_ruAllocator;             //!< selects the tiling and the RU of each station
+  std::vector<double> m_rankedWeight;           //!< weight of the ranked candidates
+  std::vector<uint8_t> m_rankedMcs;             //!< MCS of the ranked candidates
+  std::vector<uint32_t> m_rankedBytes;          //!< bytes queued for the ranked candidates
+  const RuSnrMap* m_snrMap;                     //!< the SNR map, if any
+  std::vector<float> m_rankedSnr;               //!< SNR of the ranked candidates on each position
+};
+
+} //namespace ns3
+
+#endif /* OFDMA_SCHEDULER_CORE_H */
@@ -22,13 +22,20 @@
 #include "rr-ofdma-manager.h"
 #include "wifi-ack-policy-selector.h"
 #include "wifi-phy.h"
+#include "wifi-psdu.h"
+#include "wifi-mac-trailer.h"
+#include "wifi-mac-queue.h"
+#include "block-ack-manager.h"
+#include "mpdu-aggregator.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
 #include <utility>
 #include <algorithm>
 #include <fstream>
-#include <iostream>
 #include <cmath>
-#include <ctime>
-#include <cstdlib>
+#include <limits>
 
 
 namespace ns3 {
@@ -49,6 +56,78 @@ RrOfdmaManager::GetTypeId (void)
                    UintegerValue (4),
                    MakeUintegerAccessor (&RrOfdmaManager::m_nStations),
                    MakeUintegerChecker<uint8_t> (1, 74))
+    .AddAttribute ("AdaptiveNStations",
+                   "If enabled, the maximum number of stations that can be granted an RU is "
+                   "retuned online (starting from NStations) based on the completeness of the "
+                   "MU PPDUs, the head-of-line delay and the number of backlogged stations.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RrOfdmaManager::m_adaptiveNStations),
+                   MakeBooleanChecker ())
+    .AddAttribute ("TargetHolDelay",
+                   "The target 90th percentile of the head-of-line delay of the candidate "
+                   "stations, used if AdaptiveNStations is enabled.",
+                   TimeValue (MilliSeconds (50)),
+                   MakeTimeAccessor (&RrOfdmaManager::m_targetHolDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("AdaptationEpoch",
+                   "The number of scheduling decisions between two adjustments of the maximum "
+                   "number of stations, if AdaptiveNStations is enabled.",
+                   UintegerValue (32),
+                   MakeUintegerAccessor (&RrOfdmaManager::m_adaptationEpoch),
+                   MakeUintegerChecker<uint32_t> (1, 65535))
+    .AddAttribute ("SnrAwarePlacement",
+                   "If enabled, the RUs granted to the stations are placed in the channel where "
+                   "the stations have the best SNR, as measured on the frames received from them.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RrOfdmaManager::m_snrAwarePlacement),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SnrMaxAge",
+                   "The age beyond which an SNR measurement is discarded (about the coherence "
+                   "time of the channel), if SnrAwarePlacement is enabled.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&RrOfdmaManager::m_snrMaxAge),
+                   MakeTimeChecker ())
+    .AddAttribute ("RuPowerAllocation",
+                   "If enabled, the power of the DL MU PPDU is spread across the RUs by weighted "
+                   "water-filling over the SNR of the stations on their RU. The power offsets are "
+                   "only recorded in the decision log: the PHY transmits with a uniform PSD and "
+                   "the MCSs are those the RUs were sized for.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RrOfdmaManager::m_ruPowerAllocation),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxPsdOffset",
+                   "The largest offset (dB) of the power per tone of an RU from a uniform PSD, "
+                   "in either direction, if RuPowerAllocation is enabled.",
+                   DoubleValue (3.0),
+                   MakeDoubleAccessor (&RrOfdmaManager::m_maxPsdOffset),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("PlanCacheSize",
+                   "The number of RU allocations memoized by a quantized signature of the "
+                   "candidate stations (MCS, queued bytes, relative weight), so that repeated "
+                   "traffic patterns skip the allocation search (0 disables the cache).",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&RrOfdmaManager::m_planCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("FixedPointWeights",
+                   "If enabled, the M-LWDF weights are computed in fixed point (Q-format) from the "
+                   "head-of-line delay, rate and served throughput rounded to integers.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RrOfdmaManager::m_fixedPointWeights),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BucketedCandidates",
+                   "If enabled and the policy is M-LWDF, the backlogged stations are examined "
+                   "by decreasing bound to their weight, kept in per-class priority queues, and "
+                   "the examination stops once no remaining station can be selected; all the "
+                   "backlogged stations are examined once every BucketHorizon.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RrOfdmaManager::m_bucketedCandidates),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BucketHorizon",
+                   "The time between two examinations of all the backlogged stations, "
+                   "if BucketedCandidates is enabled.",
+                   TimeValue (MilliSeconds (20)),
+                   MakeTimeAccessor (&RrOfdmaManager::m_bucketHorizon),
+                   MakeTimeChecker (NanoSeconds (1)))
     .AddAttribute ("ForceDlOfdma",
                    "If enabled, return DL_OFDMA even if no DL MU PPDU could be built.",
                    BooleanValue (false),
@@ -69,12 +148,67 @@ RrOfdmaManager::GetTypeId (void)
                    UintegerValue (20),
                    MakeUintegerAccessor (&RrOfdmaManager::m_bw),
                    MakeUintegerChecker<uint16_t> (5, 160))
+    .AddAttribute ("ThroughputTimeConstant",
+                   "The time constant of the exponentially weighted moving average of the "
+                   "throughput served to each station, used as the M-LWDF denominator.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&RrOfdmaManager::m_throughputTimeConstant),
+                   MakeTimeChecker ())
+    .AddAttribute ("MinServedThroughput",
+                   "The lowest average throughput (bit/s) accounted for a station, so that "
+                   "stations that have not been served recently do not get an unbounded weight.",
+                   DoubleValue (1e3),
+                   MakeDoubleAccessor (&RrOfdmaManager::m_minServedThroughput),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("Policy",
+                   "The policy used to weight the candidate stations.",
+                   EnumValue (MLWDF_POLICY),
+                   MakeEnumAccessor (&RrOfdmaManager::m_policy),
+                   MakeEnumChecker (MLWDF_POLICY, "MLWDF",
+                                    PF_POLICY, "PF",
+                                    EXP_PF_POLICY, "EXP_PF",
+                                    EDF_POLICY, "EDF",
+                                    MAX_WEIGHT_POLICY, "MAX_WEIGHT"))
+    .AddAttribute ("ClassMapFile",
+                   "The name of a file including, on every line, the MAC address of a station "
+                   "and its M-LWDF traffic class (1-4). Stations not listed are classified "
+                   "based on the TID of their frames.",
+                   StringValue (""),
+                   MakeStringAccessor (&RrOfdmaManager::m_classMapFile),
+                   MakeStringChecker ())
+    .AddAttribute ("TraceLevel",
+                   "The highest level of the scheduler decisions written to TraceFile "
+                   "(0: none, 1: RU grants, 2: also candidate weights). Levels higher than "
+                   "SCHEDULER_TRACE_MAX_LEVEL are not compiled in.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&RrOfdmaManager::m_traceLevel),
+                   MakeUintegerChecker<uint8_t> (0, 2))
+    .AddAttribute ("TraceFile",
+                   "The name of the binary file the scheduler decisions are written to "
+                   "(see scheduler-trace-decoder.cc).",
+                   StringValue ("rr-ofdma-trace.bin"),
+                   MakeStringAccessor (&RrOfdmaManager::m_traceFile),
+                   MakeStringChecker ())
+    .AddAttribute ("DecisionLogSize",
+                   "The number of most recent scheduling decisions kept in memory "
+                   "(0 disables the decision log).",
+                   UintegerValue (256),
+                   MakeUintegerAccessor (&RrOfdmaManager::m_decisionLogSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("DecisionDumpFile",
+                   "The name of the file the decision log is written to when the "
+                   "simulation ends (no file if empty).",
+                   StringValue (""),
+                   MakeStringAccessor (&RrOfdmaManager::m_decisionDumpFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
 
 RrOfdmaManager::RrOfdmaManager ()
-  : m_startStation (0)
+  : m_maxUsersPerPpdu (1),
+    m_startStation (0),
+    m_tracesConnected (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -84,6 +218,33 @@ RrOfdmaManager::~RrOfdmaManager ()
   NS_LOG_FUNCTION_NOARGS ();
 }
 
+void
+RrOfdmaManager::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_trace.Close ();
+  if (!m_decisionDumpFile.empty ())
+    {
+      std::ofstream file (m_decisionDumpFile);
+      NS_ABORT_MSG_IF (!file.is_open (), "Cannot open " << m_decisionDumpFile);
+      DumpDecisions (file);
+    }
+  OfdmaManager::DoDispose ();
+}
+
+void
+RrOfdmaManager::DumpDecisions (std::ostream& os) const
+{
+  m_decisions.Dump (os);
+}
+
+void
+RrOfdmaManager::SetStationClass (Mac48Address address, uint8_t trafficClass)
+{
+  NS_LOG_FUNCTION (this << address << +trafficClass);
+  m_classifier.SetStationClass (address, trafficClass);
+}
+
 
  /**
    * Compute the TX vector and the TX params for a DL MU transmission assuming
@@ -95,18 +256,11 @@ RrOfdmaManager::~RrOfdmaManager ()
    * \param dlMuAckSequence the ack sequence type
    */
 
+template <class StaList>
 void
-RrOfdmaManager::InitTxVectorAndParams (std::map<Mac48Address, DlPerStaInfo> staList,
-                                         HeRu::RuType ruType, DlMuAckSequenceType dlMuAckSequence)
+RrOfdmaManager::InitTxVectorAndParams (const StaList& staList,
+                                       HeRu::RuType ruType, DlMuAckSequenceType dlMuAckSequence)
 {
-
-	auto mp=staList.begin();
-          while(mp!=staList.end()){
-          	std::cout<<"\n  Dlofdma in InitTxVectorAndParams"<<mp->first;
-          	mp++;
-          }
-
-  std::cout<<"\n start: InitTxVectorAndParams";
   NS_LOG_FUNCTION (this);
 //NS_LOG_FUNCTION("ru:::::::::"<<ruType);
   m_txVector = WifiTxVector ();
@@ -120,10 +274,6 @@ RrOfdmaManager::InitTxVectorAndParams (std::map<Mac48Address, DlPerStaInfo> staL
 
   Ptr<WifiMacQueueItem> mpdu = Copy (m_mpdu);
 
-std::cout<<"\n inside InitTxVectorAndParams: before for loop\n";
-
-/////////////////////////////////////////Reshan
-unsigned int i=0; 
   for (auto& sta : staList)
     {
       mpdu->GetHeader ().SetAddr1 (sta.first);
@@ -135,16 +285,16 @@ unsigned int i=0;
 
 
 ///////ReshanFaraz///////////////////
-std::cout<<"\n inside InitTxVectorAndParams: before your code\n";
 
-if(finalRUAlloc.size()!=0){
-  std::cout<<"mappedRuAllocated-----"<<mappedRuAllocated[i];
-
-  m_txVector.SetHeMuUserInfo (sta.second.aid, {{false,mappedRuAllocated[i], 1}, suTxVector.GetMode (), suTxVector.GetNss ()});
-  i++;
-}
-else      
-  m_txVector.SetHeMuUserInfo (sta.second.aid, {{false, ruType, 1}, suTxVector.GetMode (), suTxVector.GetNss ()});
+      // use the RU selected by the allocator, if any, and the MCS the RU was sized for
+      HeRu::RuSpec ru = {false, ruType, 1};
+      WifiMode mode = suTxVector.GetMode ();
+      if (m_staTable.HasRu (sta.second.aid))
+        {
+          ru = m_staTable.GetRu (sta.second.aid);
+          mode = WifiPhy::GetHeMcs (m_staTable.GetMcs (sta.second.aid));
+        }
+      m_txVector.SetHeMuUserInfo (sta.second.aid, {ru, mode, suTxVector.GetNss ()});
 //////////////////////////////
 
       // Add the receiver station to the appropriate list of the TX params
@@ -200,6 +350,11 @@ RrOfdmaManager::SelectTxFormat (Ptr<const WifiMacQueueItem> mpdu)
   NS_LOG_FUNCTION (this << *mpdu);
   NS_ASSERT (mpdu->GetHeader ().IsQosData ());
 
+  if (!m_tracesConnected)
+    {
+      ConnectTraces ();
+    }
+
 
 
   if (m_enableUlOfdma && GetTxFormat () == DL_OFDMA)
@@ -209,73 +364,35 @@ RrOfdmaManager::SelectTxFormat (Ptr<const WifiMacQueueItem> mpdu)
 
       Ptr<QosTxop> txop = m_qosTxop[QosUtilsMapTidToAc (mpdu->GetHeader ().GetQosTid ())];
       m_ulMuAckSequence = txop->GetAckPolicySelector ()->GetAckSequenceForUlMu ();
-      MacLowTransmissionParameters params;
-      params.SetUlMuAckSequenceType (m_ulMuAckSequence);
-      BlockAckType baType;
-
-      if (m_ulMuAckSequence == UL_MULTI_STA_BLOCK_ACK)
-        {
-          baType = BlockAckType::MULTI_STA;
-          for (auto& userInfo : m_txVector.GetHeMuUserInfoMap ())
-            {
-              auto addressIt = m_apMac->GetStaList ().find (userInfo.first);
-              if (addressIt != m_apMac->GetStaList ().end ())
-                {
-                  baType.m_bitmapLen.push_back (32);
-                  params.EnableBlockAck (addressIt->second, baType);
-                }
-              else
-                {
-                  NS_LOG_WARN ("Maybe station with AID=" << userInfo.first << " left the BSS since the last MU DL transmission?");
-                }
-            }
-        }
-      else
-        {
-          NS_FATAL_ERROR ("Sending Block Acks in an MU DL PPDU is not supported yet");
-        }
-
-      CtrlTriggerHeader trigger (TriggerFrameType::BASIC_TRIGGER, m_txVector);
 
       // compute the maximum amount of time that can be granted to stations.
       // This value is limited by the max PPDU duration
-      Time maxDuration = GetPpduMaxTime (m_txVector.GetPreambleType ());
-
-      // compute the time required by stations based on the buffer status reports, if any
-      uint32_t maxBufferSize = 0;
+      Time maxDuration = GetPpduMaxTime (WIFI_PREAMBLE_HE_MU);
 
-      for (auto& userInfo : m_txVector.GetHeMuUserInfoMap ())
+      // select the stations to solicit and their RUs based on their buffer status.
+      // If no station has buffered frames, skip UL OFDMA and proceed with trying DL OFDMA
+      if (ComputeUlTxVector (mpdu, maxDuration) > 0)
         {
-          auto addressIt = m_apMac->GetStaList ().find (userInfo.first);
-          if (addressIt != m_apMac->GetStaList ().end ())
+          MacLowTransmissionParameters params;
+          params.SetUlMuAckSequenceType (m_ulMuAckSequence);
+          BlockAckType baType;
+
+          if (m_ulMuAckSequence == UL_MULTI_STA_BLOCK_ACK)
             {
-              uint8_t queueSize = m_apMac->GetMaxBufferStatus (addressIt->second);
-              if (queueSize == 255)
-                {
-                  NS_LOG_DEBUG ("Buffer status of station " << addressIt->second << " is unknown");
-                  maxBufferSize = std::max (maxBufferSize, m_ulPsduSize);
-                }
-              else if (queueSize == 254)
+              baType = BlockAckType::MULTI_STA;
+              for (auto& userInfo : m_ulTxVector.GetHeMuUserInfoMap ())
                 {
-                  NS_LOG_DEBUG ("Buffer status of station " << addressIt->second << " is not limited");
-                  maxBufferSize = 0xffffffff;
-                  break;
-                }
-              else
-                {
-                  NS_LOG_DEBUG ("Buffer status of station " << addressIt->second << " is " << +queueSize);
-                  maxBufferSize = std::max (maxBufferSize, static_cast<uint32_t> (queueSize * 256));
+                  baType.m_bitmapLen.push_back (32);
+                  params.EnableBlockAck (m_ulStaTable.GetAddress (userInfo.first), baType);
                 }
             }
           else
             {
-              NS_LOG_WARN ("Maybe station with AID=" << userInfo.first << " left the BSS since the last MU DL transmission?");
+              NS_FATAL_ERROR ("Sending Block Acks in an MU DL PPDU is not supported yet");
             }
-        }
 
-      // if the maximum buffer size is 0, skip UL OFDMA and proceed with trying DL OFDMA
-      if (maxBufferSize > 0)
-        {
+          CtrlTriggerHeader trigger (TriggerFrameType::BASIC_TRIGGER, m_ulTxVector);
+
           // if we are within a TXOP, we have to consider the response time and the
           // remaining TXOP duration
           if (txop->GetTxopLimit ().IsStrictlyPositive ())
@@ -293,7 +410,7 @@ RrOfdmaManager::SelectTxFormat (Ptr<const WifiMacQueueItem> mpdu)
               hdr.SetAddr1 (Mac48Address::GetBroadcast ());
               Ptr<WifiMacQueueItem> item = Create<WifiMacQueueItem> (packet, hdr);
 
-              Time response = m_low->GetResponseDuration (params, m_txVector, item);
+              Time response = m_low->GetResponseDuration (params, m_ulTxVector, item);
 
               // Add the time to transmit the Trigger Frame itself
               WifiTxVector txVector = GetWifiRemoteStationManager ()->GetRtsTxVector (hdr.GetAddr1 (), &hdr, packet);
@@ -302,44 +419,53 @@ RrOfdmaManager::SelectTxFormat (Ptr<const WifiMacQueueItem> mpdu)
                                                                  m_low->GetPhy ()->GetFrequency ());
 
               // Subtract the duration of the HE TB PPDU
-              response -= WifiPhy::ConvertLSigLengthToHeTbPpduDuration (length, m_txVector,
+              response -= WifiPhy::ConvertLSigLengthToHeTbPpduDuration (length, m_ulTxVector,
                                                                         m_low->GetPhy ()->GetFrequency ());
 
               if (response > txop->GetTxopRemaining ())
                 {
-                  // an UL OFDMA transmission is not possible. Reset m_staInfo and return DL_OFDMA.
+                  // an UL OFDMA transmission is not possible. Reset the candidates and return DL_OFDMA.
                   // In this way, no transmission will occur now and the next time we will try again
                   // performing an UL OFDMA transmission.
                   NS_LOG_DEBUG ("Remaining TXOP duration is not enough for UL MU exchange");
-                  m_staInfo.clear ();
+                  m_staTable.ClearCandidates ();
                   return DL_OFDMA;
                 }
 
               maxDuration = Min (maxDuration, txop->GetTxopRemaining () - response);
             }
 
-          Time bufferTxTime = m_low->GetPhy ()->CalculateTxDuration (maxBufferSize, m_txVector,
-                                                                     m_low->GetPhy ()->GetFrequency (),
-                                                                     trigger.begin ()->GetAid12 ());
+          // the HE TB PPDU lasts as long as the station that needs the most time
+          // to send its buffered bytes in its RU, so that the padding sent by the
+          // other stations is minimized
+          Time bufferTxTime = Seconds (0);
+          for (auto& userInfo : m_ulTxVector.GetHeMuUserInfoMap ())
+            {
+              bufferTxTime = Max (bufferTxTime,
+                                  m_low->GetPhy ()->CalculateTxDuration (m_ulStaTable.GetBacklog (userInfo.first),
+                                                                         m_ulTxVector,
+                                                                         m_low->GetPhy ()->GetFrequency (),
+                                                                         userInfo.first));
+            }
           if (bufferTxTime < maxDuration)
             {
-              // the maximum buffer size can be transmitted within the allowed time
+              // the buffered bytes can be transmitted within the allowed time
               maxDuration = bufferTxTime;
             }
           else
             {
               // maxDuration may be a too short time. If it does not allow to transmit
               // at least m_ulPsduSize bytes, give up the UL MU transmission for now
-              Time minDuration = m_low->GetPhy ()->CalculateTxDuration (m_ulPsduSize, m_txVector,
+              Time minDuration = m_low->GetPhy ()->CalculateTxDuration (m_ulPsduSize, m_ulTxVector,
                                                                         m_low->GetPhy ()->GetFrequency (),
                                                                         trigger.begin ()->GetAid12 ());
               if (maxDuration < minDuration)
                 {
-                  // maxDuration is a too short time. Reset m_staInfo and return DL_OFDMA.
+                  // maxDuration is a too short time. Reset the candidates and return DL_OFDMA.
                   // In this way, no transmission will occur now and the next time we will try again
                   // performing an UL OFDMA transmission.
                   NS_LOG_DEBUG ("Available time " << maxDuration << " is too short");
-                  m_staInfo.clear ();
+                  m_staTable.ClearCandidates ();
                   return DL_OFDMA;
                 }
             }
@@ -348,7 +474,7 @@ RrOfdmaManager::SelectTxFormat (Ptr<const WifiMacQueueItem> mpdu)
           NS_LOG_DEBUG ("HE TB PPDU duration: " << maxDuration.ToDouble (Time::MS));
           uint16_t length = WifiPhy::ConvertHeTbPpduDurationToLSigLength (maxDuration,
                                                                           m_low->GetPhy ()->GetFrequency ());
-          m_txVector.SetLength (length);
+          m_ulTxVector.SetLength (length);
           m_txParams = params;
           return UL_OFDMA;
         }
@@ -365,14 +491,15 @@ RrOfdmaManager::SelectTxFormat (Ptr<const WifiMacQueueItem> mpdu)
     {
       startIt = staList.begin ();
       m_startStation = startIt->first;
-std::cout<<"SelectTxFormat: if (startIt == staList.end ()),  start station"<<m_startStation<<"\n";
 
     }
 
 
   uint8_t currTid = mpdu->GetHeader ().GetQosTid ();
   AcIndex primaryAc = QosUtilsMapTidToAc (currTid);
-  m_staInfo.clear ();
+  m_staTable.ClearCandidates ();
+  // the scratch data of the previous cycle is no longer used
+  m_arena.Reset ();
 
   // If the primary AC holds a TXOP, we can select a station as a receiver of
   // the MU PPDU only if the AP has frames to send to such station that fit into
@@ -385,7 +512,10 @@ std::cout<<"SelectTxFormat: if (startIt == staList.end ()),  start station"<<m_s
   // the list of associated stations.
 
 
-  std::size_t count = m_nStations;
+  // the cap retuned by the controller does not overwrite the NStations attribute
+  m_maxUsersPerPpdu = (m_adaptiveNStations ? m_maxUsers.GetMaxUsers () : m_nStations);
+  NS_LOG_DEBUG ("Maximum number of stations: " << m_maxUsersPerPpdu);
+  std::size_t count = m_maxUsersPerPpdu;
 
 
   HeRu::RuType ruType = GetNumberAndTypeOfRus (m_low->GetPhy ()->GetChannelWidth (), count);
@@ -394,7 +524,7 @@ std::cout<<"SelectTxFormat: if (startIt == staList.end ()),  start station"<<m_s
 
   NS_ASSERT (count >= 1);
 
-  std::map<Mac48Address, DlPerStaInfo> guess;
+  ScratchStaList guess {ArenaAllocator<ScratchStaList::value_type> (m_arena)};
   auto staIt = startIt;
   do
     {
@@ -441,97 +571,56 @@ InitTxVectorAndParams (guess, ruType, m_dlMuAckSequence);
         }
     }
 
+  // time available to the RU allocator for the transmission of the DL MU PPDU
+  m_availableTime = GetPpduMaxTime (WIFI_PREAMBLE_HE_MU);
+  if (txopLimit.IsStrictlyPositive ())
+    {
+      m_availableTime = Min (m_availableTime, txopLimit);
+    }
 
 /////////////////////////////////////////////////////////////////
-dataStaPair1.clear(); 
-v_QosType.clear();
-v_powerLevel.clear();
-v_dataStaPair.clear();
-finalStaPairIndex.clear();
+  Time now = Simulator::Now ();
 
+  // the candidate queue only bounds the M-LWDF weights
+  bool bucketed = m_bucketedCandidates && m_policy == MLWDF_POLICY;
 
-  do
+  if (!bucketed || m_candidateQueue.NeedsRebuild (now.GetNanoSeconds ()))
     {
-      NS_LOG_DEBUG ("Next candidate STA (MAC=" << startIt->second << ", AID=" << startIt->first << ")");
-      // check if the AP has at least one frame to be sent to the current station
-      for (uint8_t tid : std::initializer_list<uint8_t> {currTid, 1, 2, 0, 3, 4, 5, 6, 7})
+      // only the stations the AP has frames for are visited. All of them are
+      // visited, so that the stations to serve can be ranked by weight. The
+      // visit starts at m_startStation and wraps around, so that the stations
+      // granted RUs of equal size when no RU allocation is feasible (the first
+      // candidates) change from one TXOP to the next
+      m_popped.clear ();
+      for (uint16_t aid = m_backlog.GetNext (m_startStation); aid != BacklogIndex::NONE;
+           aid = m_backlog.GetNext (aid + 1u))
         {
-          AcIndex ac = QosUtilsMapTidToAc (tid);
-          // check that a BA agreement is established with the receiver for the
-          // considered TID, since ack sequences for DL MU PPDUs require block ack
-          if (ac >= primaryAc && m_qosTxop[ac]->GetBaAgreementEstablished (startIt->second, tid))
+          EvaluateCandidate (aid, currTid, primaryAc, ruType, txopLimit, now);
+          if (bucketed)
             {
-              mpdu = m_qosTxop[ac]->PeekNextFrame (tid, startIt->second);
-
-              // we only check if the first frame of the current TID meets the size
-              // and duration constraints. We do not explore the queues further.
-              if (mpdu != 0)
-                {
-                  // Use a temporary TX vector including only the STA-ID of the
-                  // candidate station to check if the MPDU meets the size and time limits.
-                  // An RU of the computed size is tentatively assigned to the candidate
-                  // station, so that the TX duration can be correctly computed.
-                  WifiTxVector suTxVector = m_low->GetDataTxVector (mpdu),
-                               muTxVector;
-
-                  muTxVector.SetPreambleType (WIFI_PREAMBLE_HE_MU);
-                  muTxVector.SetChannelWidth (m_low->GetPhy ()->GetChannelWidth ());
-                  muTxVector.SetGuardInterval (m_low->GetPhy ()->GetGuardInterval ().GetNanoSeconds ());
-                  muTxVector.SetHeMuUserInfo (startIt->first,
-                                              {{false, ruType, 1}, suTxVector.GetMode (), suTxVector.GetNss ()});
-
-                  if (m_low->IsWithinSizeAndTimeLimits (mpdu, muTxVector, 0, txopLimit))
-                    {
-
-                      int type_Qos;
-                      if((startIt->second=="00:00:00:00:00:01") || (startIt->second=="00:00:00:00:00:05") || (startIt->second=="00:00:00:00:00:09") || (startIt->second=="00:00:00:00:00:0d") || (startIt->second=="00:00:00:00:00:11") || (startIt->second=="00:00:00:00:00:15") || (startIt->second=="00:00:00:00:00:19") || (startIt->second=="00:00:00:00:00:1d")){
-                        std::cout<<"\n Inside Type Qos 1";
-                        type_Qos=1;
-                      }
-                      else if((startIt->second=="00:00:00:00:00:03") || (startIt->second=="00:00:00:00:00:07") || (startIt->second=="00:00:00:00:00:0b") || (startIt->second=="00:00:00:00:00:0e") || (startIt->second=="00:00:00:00:00:13") || (startIt->second=="00:00:00:00:00:17") || (startIt->second=="00:00:00:00:00:1b") || (startIt->second=="00:00:00:00:00:1f"))
-                      {
-                        std::cout<<"\n Inside Type Qos 3";
-                        type_Qos=3;
-                      }
-                      else if((startIt->second=="00:00:00:00:00:04") || (startIt->second=="00:00:00:00:00:08") ||(startIt->second=="00:00:00:00:00:0c") || (startIt->second=="00:00:00:00:00:0f") || (startIt->second=="00:00:00:00:00:14") || (startIt->second=="00:00:00:00:00:18") || (startIt->second=="00:00:00:00:00:1c") || (startIt->second=="00:00:00:00:00:20"))
-                      {
-                        std::cout<<"\n Inside Type Qos 2";
-                        type_Qos=2;
-                      } 
-                      else{
-                        std::cout<<"\n Inside Type Qos Else";
-                        type_Qos=4;
-                      }
-                  
-
-                      v_QosType.push_back(type_Qos);
-                       v_dataStaPair.push_back(mpdu->GetPacket()->GetSize());
-
-  //        
-                      // the frame meets the constraints, add the station to the list
-                      NS_LOG_DEBUG ("Adding candidate STA (MAC=" << startIt->second << ", AID="
-                                    << startIt->first << ") TID=" << +tid);
-                      DlPerStaInfo info {startIt->first, tid};
-                      m_staInfo.push_back (std::make_pair (startIt->second, info));
-                      break;    // terminate the for loop
-                    }
-                }
-              else
-                {
-                  NS_LOG_DEBUG ("No frames to send to " << startIt->second << " with TID=" << +tid);
-                }
+              m_popped.push_back (aid);
             }
         }
-
-      // move to the next station in the map
-      startIt++;
-      if (startIt == staList.end ())
+      for (uint16_t aid = m_backlog.GetNext (0); aid < m_startStation; aid = m_backlog.GetNext (aid + 1u))
         {
-          startIt = staList.begin ();
+          EvaluateCandidate (aid, currTid, primaryAc, ruType, txopLimit, now);
+          if (bucketed)
+            {
+              m_popped.push_back (aid);
+            }
         }
-    } while (m_staInfo.size () < m_nStations && startIt->first != m_startStation);
+      if (bucketed)
+        {
+          m_candidateQueue.Reset (now.GetNanoSeconds ());
+          RequeueCandidates (now);
+        }
+    }
+  else
+    {
+      SelectBucketedCandidates (currTid, primaryAc, ruType, txopLimit, now);
+    }
 
-  if (m_staInfo.empty ())
+  if (m_staTable.GetCandidates ().empty ())
     {
       if (m_forceDlOfdma)
         {
@@ -542,13 +631,142 @@ finalStaPairIndex.clear();
       return OfdmaTxFormat::NON_OFDMA;
     }
 
+  return OfdmaTxFormat::DL_OFDMA;
+}
 
+bool
+RrOfdmaManager::EvaluateCandidate (uint16_t aid, uint8_t currTid, AcIndex primaryAc, HeRu::RuType ruType,
+                                   Time txopLimit, Time now)
+{
+  Mac48Address address = m_staTable.GetAddress (aid);
+  uint8_t tids = m_backlog.GetTids (aid);
+  NS_LOG_DEBUG ("Next candidate STA (MAC=" << address << ", AID=" << aid << ")");
+  // check if the AP has at least one frame to be sent to the current station
+  for (uint8_t tid : std::initializer_list<uint8_t> {currTid, 1, 2, 0, 3, 4, 5, 6, 7})
+    {
+      AcIndex ac = QosUtilsMapTidToAc (tid);
+      // check that a BA agreement is established with the receiver for the
+      // considered TID, since ack sequences for DL MU PPDUs require block ack
+      if ((tids & (1 << tid)) != 0 && ac >= primaryAc
+          && m_qosTxop[ac]->GetBaAgreementEstablished (address, tid))
+        {
+          Ptr<const WifiMacQueueItem> mpdu = m_qosTxop[ac]->PeekNextFrame (tid, address);
 
+          // we only check if the first frame of the current TID meets the size
+          // and duration constraints. We do not explore the queues further.
+          if (mpdu != 0)
+            {
+              // Use a temporary TX vector including only the STA-ID of the
+              // candidate station to check if the MPDU meets the size and time limits.
+              // An RU of the computed size is tentatively assigned to the candidate
+              // station, so that the TX duration can be correctly computed.
+              WifiTxVector suTxVector = m_low->GetDataTxVector (mpdu),
+                           muTxVector;
+
+              muTxVector.SetPreambleType (WIFI_PREAMBLE_HE_MU);
+              muTxVector.SetChannelWidth (m_low->GetPhy ()->GetChannelWidth ());
+              muTxVector.SetGuardInterval (m_low->GetPhy ()->GetGuardInterval ().GetNanoSeconds ());
+              muTxVector.SetHeMuUserInfo (aid, {{false, ruType, 1}, suTxVector.GetMode (), suTxVector.GetNss ()});
+
+              if (m_low->IsWithinSizeAndTimeLimits (mpdu, muTxVector, 0, txopLimit))
+                {
+                  // the frame meets the constraints, add the station to the candidates
+                  // along with the MCS currently selected by the rate manager
+                  uint8_t mcs = (suTxVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_HE
+                                 ? suTxVector.GetMode ().GetMcsValue () : 0);
+                  uint32_t bytes = GetSendableBytes (aid, address, tid, mpdu->GetSize ());
+                  NS_LOG_DEBUG ("Adding candidate STA (MAC=" << address << ", AID=" << aid
+                                << ") TID=" << +tid << " MCS=" << +mcs << " bytes=" << bytes);
+                  m_staTable.AddCandidate (aid, address, tid, bytes,
+                                           m_classifier.GetClass (aid, tid), mcs,
+                                           mpdu->GetTimeStamp ().GetNanoSeconds (),
+                                           m_servedThroughput.GetStaThroughput (aid, now) / 1e6);
+                  return true;
+                }
+            }
+          else if (GetHolTimestamp (address, tid) == Time::Max ())
+            {
+              // the frames left the queue without being notified
+              NS_LOG_DEBUG ("No frames to send to " << address << " with TID=" << +tid);
+              m_backlog.Clear (aid, tid);
+            }
+          // otherwise the queued frames cannot be sent yet (e.g., they are
+          // outside the Block Ack window) and the TID stays backlogged
+        }
+    }
+  return false;
+}
+
+void
+RrOfdmaManager::SelectBucketedCandidates (uint8_t currTid, AcIndex primaryAc, HeRu::RuType ruType,
+                                          Time txopLimit, Time now)
+{
+  uint16_t width = m_low->GetPhy ()->GetChannelWidth ();
+  uint16_t guardInterval = m_low->GetPhy ()->GetGuardInterval ().GetNanoSeconds ();
+  uint8_t fullBandRu = HeRateTable::GetRuIndex (HeRateTable::GetFullBandRuTones (width));
+
+  // the stations are examined by decreasing bound until m_maxUsersPerPpdu
+  // candidates are found and no remaining station can outweigh them
+  m_popped.clear ();
+  m_candidateQueue.StartSelection (m_maxUsersPerPpdu);
+  while (!m_candidateQueue.IsSelectionDone ())
+    {
+      uint16_t aid = m_candidateQueue.Pop ();
+      m_popped.push_back (aid);
 
+      if (m_backlog.GetTids (aid) == 0
+          || !EvaluateCandidate (aid, currTid, primaryAc, ruType, txopLimit, now))
+        {
+          continue;
+        }
 
+      // the weight the core computes for the candidate
+      m_candidateQueue.AddSelected (m_staTable.GetClass (aid),
+                                    StaStateTable::GetHolDelay (now.GetNanoSeconds (), m_staTable.GetHolTimestamp (aid)),
+                                    HeRateTable::GetRateKbps (m_staTable.GetMcs (aid), width, guardInterval, fullBandRu) / 1e3,
+                                    m_servedThroughput.GetStaThroughput (aid, now) / 1e6);
+    }
+  RequeueCandidates (now);
+}
 
-  m_startStation = startIt->first;
-  return OfdmaTxFormat::DL_OFDMA;
+void
+RrOfdmaManager::RequeueCandidates (Time now)
+{
+  for (auto aid : m_popped)
+    {
+      // the TID a station is served for depends on the TID and the AC of the
+      // TXOP, hence the bound covers the oldest frame of every backlogged TID
+      Mac48Address address = m_staTable.GetAddress (aid);
+      double avgThroughput = m_servedThroughput.GetStaThroughput (aid, now) / 1e6;
+      uint8_t boundClass = TrafficClassifier::UNKNOWN;
+      double bound = 0;
+      for (uint8_t tid = 0; tid < 8; tid++)
+        {
+          if ((m_backlog.GetTids (aid) & (1 << tid)) == 0)
+            {
+              continue;
+            }
+          Time holTimestamp = GetHolTimestamp (address, tid);
+          if (holTimestamp == Time::Max ())
+            {
+              // the frames left the queue without being notified
+              m_backlog.Clear (aid, tid);
+              continue;
+            }
+          uint8_t trafficClass = m_classifier.GetClass (aid, tid);
+          double tidBound = m_candidateQueue.GetBound (trafficClass, holTimestamp.GetNanoSeconds (), avgThroughput);
+          if (boundClass == TrafficClassifier::UNKNOWN || tidBound > bound)
+            {
+              boundClass = trafficClass;
+              bound = tidBound;
+            }
+        }
+      // a station with no frame is queued again when a frame is enqueued for it
+      if (boundClass != TrafficClassifier::UNKNOWN)
+        {
+          m_candidateQueue.Push (aid, boundClass, bound);
+        }
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -604,756 +822,427 @@ NS_LOG_FUNCTION("--: "<<ruType);
 
 
 
-double RrOfdmaManager::type_of_App(int type_of_Application)
+void
+RrOfdmaManager::ConnectTraces (void)
 {
-  std::cout<<"\ncalculating Type of Application";
-  double a_i=0;
-  switch(type_of_Application){
-    case 1:
-    a_i=10;
-    
-    break;
-
-    case 2:
-    a_i=5.4927;
-    
-    break;
-
-    case 3:
-    a_i=2.3299;
-    
-    break;
-
-    case 4:
-    a_i=1.50515;
-     break;
-    default:
-    break;
-  }
-  return a_i;
-    
-
-}
-
-
+  NS_LOG_FUNCTION (this);
+  m_servedThroughput.SetTimeConstant (m_throughputTimeConstant);
+  m_ulServedThroughput.SetTimeConstant (m_throughputTimeConstant);
+  m_servedThroughput.SetMinThroughput (m_minServedThroughput);
+  m_ulServedThroughput.SetMinThroughput (m_minServedThroughput);
+  if (m_traceLevel > SchedulerTrace::NONE)
+    {
+      m_trace.Open (m_traceFile, m_traceLevel);
+    }
+  if (m_adaptiveNStations)
+    {
+      m_maxUsers.SetCap (m_nStations, HeRuTiling::Get (m_low->GetPhy ()->GetChannelWidth ()).GetMaxRus ());
+      m_maxUsers.SetEpoch (m_adaptationEpoch);
+      m_maxUsers.SetTargetDelay (m_targetHolDelay.GetNanoSeconds ());
+    }
+  m_snrMap.SetMaxAge (m_snrMaxAge.GetNanoSeconds ());
+  if (m_snrAwarePlacement)
+    {
+      m_core.SetSnrMap (&m_snrMap);
+      m_ulCore.SetSnrMap (&m_snrMap);
+    }
+  m_core.SetFixedPoint (m_fixedPointWeights);
+  m_ulCore.SetFixedPoint (m_fixedPointWeights);
+  if (m_planCacheSize > 0)
+    {
+      std::size_t maxRus = HeRuTiling::Get (m_low->GetPhy ()->GetChannelWidth ()).GetMaxRus ();
+      m_core.SetPlanCache (m_planCacheSize, maxRus);
+      m_ulCore.SetPlanCache (m_planCacheSize, maxRus);
+    }
+  // the served throughput of a station that is not served decays by at most
+  // exp (horizon / time constant) within the horizon
+  m_candidateQueue.SetHorizon (m_bucketHorizon.GetNanoSeconds (),
+                               std::exp (m_bucketHorizon.GetSeconds () / m_throughputTimeConstant.GetSeconds ()));
+  // the bounds assume the largest rate, so that they hold if the MCS changes
+  uint16_t width = m_low->GetPhy ()->GetChannelWidth ();
+  m_candidateQueue.SetWeights (m_fixedPointWeights,
+                               HeRateTable::GetRateKbps (HeRateTable::N_MCS - 1, width,
+                                                         m_low->GetPhy ()->GetGuardInterval ().GetNanoSeconds (),
+                                                         HeRateTable::GetRuIndex (HeRateTable::GetFullBandRuTones (width))) / 1e3);
+  if (m_decisionLogSize > 0)
+    {
+      m_decisions.SetCapacity (m_decisionLogSize,
+                               HeRuTiling::Get (m_low->GetPhy ()->GetChannelWidth ()).GetMaxRus ());
+    }
+  m_low->TraceConnectWithoutContext ("ForwardDown",
+                                     MakeCallback (&RrOfdmaManager::NotifyPsduForwardedDown, this));
+  m_low->GetPhy ()->TraceConnectWithoutContext ("MonitorSnifferRx",
+                                                MakeCallback (&RrOfdmaManager::NotifyMonitorSnifferRx, this));
+  for (AcIndex ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+    {
+      // MPDUs to retransmit are held in the retransmit queue of the Block Ack manager
+      for (Ptr<WifiMacQueue> queue : {m_qosTxop[ac]->GetWifiMacQueue (),
+                                      m_qosTxop[ac]->GetBaManager ()->GetRetransmitQueue ()})
+        {
+          queue->TraceConnectWithoutContext ("Enqueue", MakeCallback (&RrOfdmaManager::NotifyMpduEnqueued, this));
+          queue->TraceConnectWithoutContext ("Dequeue", MakeCallback (&RrOfdmaManager::NotifyMpduDequeued, this));
+          queue->TraceConnectWithoutContext ("Expired", MakeCallback (&RrOfdmaManager::NotifyMpduDequeued, this));
+        }
+    }
 
-static double returnRate(int rand_mcs,uint16_t bw) {
-  if(bw==20){
-  switch(rand_mcs) {
-    case 1: return 8.1;     //BPSK 1/2
-    case 2: return 16.3;    //QPSK 1/2
-    case 3: return 24.4;    //QPSK 3/4
-    case 4: return 32.5;    //16-QAM 1/2
-    case 5: return 48.8;    //16-QAM 3/4    
-    case 6: return 65.0;    //64-QAM 2/3
-    case 7: return 73.1;    //64-QAM 3/4
-    case 8: return 81.3;    //64-QAM 5/6
-    case 9: return 97.5;    //256-QAM 3/4
-    case 10: return 108.3;    //256-QAM 5/6
-    case 11: return 129.0;    //1024-QAM 3/4
-    case 12: return 135.4;    //1024-QAM 5/6  
-    default: return 0.0;
-  }
-}
-else{
-  switch(rand_mcs) {
-    case 1: return 16.3;    //BPSK 1/2
-    case 2: return 32.5;    //QPSK 1/2
-    case 3: return 48.8;    //QPSK 3/4
-    case 4: return 65.0;    //16-QAM 1/2
-    case 5: return 97.5;    //16-QAM 3/4    
-    case 6: return 130.0;   //64-QAM 2/3
-    case 7: return 146.3;   //64-QAM 3/4
-    case 8: return 162.5;   //64-QAM 5/6
-    case 9: return 195.0;   //256-QAM 3/4
-    case 10: return 216.7;    //256-QAM 5/6 
-    case 11: return 243.8;    //1024-QAM 3/4
-    case 12: return 270.8;    //1024-QAM 5/6
-    default: return 0.0;
-  }
-}
+  if (!m_classMapFile.empty ())
+    {
+      m_classifier.Load (m_classMapFile);
+    }
+  for (auto& sta : m_apMac->GetStaList ())
+    {
+      m_classifier.NotifyAssociation (sta.first, sta.second);
+      m_staTable.NotifyAssociation (sta.first, sta.second);
+      m_ulStaTable.NotifyAssociation (sta.first, sta.second);
+      m_ulBufferStatus.NotifyAssociation (sta.first, Simulator::Now ().GetNanoSeconds ());
+      m_snrMap.NotifyAssociation (sta.first);
+      InitBacklog (sta.first, sta.second);
+    }
+  m_apMac->TraceConnectWithoutContext ("AssociatedSta",
+                                       MakeCallback (&RrOfdmaManager::NotifyStaAssociated, this));
+  m_apMac->TraceConnectWithoutContext ("DeAssociatedSta",
+                                       MakeCallback (&RrOfdmaManager::NotifyStaDeassociated, this));
+  m_tracesConnected = true;
 }
 
-double RrOfdmaManager::timeReq(uint32_t dataSize,int mcs)
+void
+RrOfdmaManager::NotifyStaAssociated (uint16_t aid, Mac48Address address)
 {
-    if(dataSize==0)
-        return 0;
-    double symbols=0.0;  
-    uint32_t bits=dataSize*8;
- std::cout<<"\n Inside Time Req";
-   double encodeingRate=5.0/6.0;
-int mcs_QAM=2;
-switch(mcs){
-
-case 0: 
-encodeingRate=1.0/2.0;
-mcs_QAM=2;
-break;
-
-case 1: 
-encodeingRate=1.0/2.0;
-mcs_QAM=4;
-break;
-
-case 2: 
-encodeingRate=3.0/4.0;
-mcs_QAM=4;
-break;
-
-case 3: 
-encodeingRate=1.0/2.0;
-mcs_QAM=16;
-break;
-
-case 4: 
-encodeingRate=3.0/4.0;
-mcs_QAM=16;
-break;
-
-case 5: 
-encodeingRate=2.0/3.0;
-mcs_QAM=64;
-break;
-
-case 6: 
-encodeingRate=3.0/4.0;
-mcs_QAM=64;
-break;
-
-case 7: 
-encodeingRate=5.0/6.0;
-mcs_QAM=64;
-break;
-
-case 8: 
-encodeingRate=3.0/4.0;
-mcs_QAM=256;
-break;
-
-case 9: 
-encodeingRate=5.0/6.0;
-mcs_QAM=256;
-break;
-
-case 10: 
-encodeingRate=3.0/4.0;
-mcs_QAM=1024;
-break;
-
-case 11: 
-encodeingRate=5.0/6.0;
-mcs_QAM=1024;
-break;
-
-default: 
-break;
-
+  NS_LOG_FUNCTION (this << aid << address);
+  m_classifier.NotifyAssociation (aid, address);
+  m_staTable.NotifyAssociation (aid, address);
+  m_ulStaTable.NotifyAssociation (aid, address);
+  m_ulBufferStatus.NotifyAssociation (aid, Simulator::Now ().GetNanoSeconds ());
+  m_snrMap.NotifyAssociation (aid);
+  InitBacklog (aid, address);
 }
-    double bitsPerSec=log2f(mcs_QAM)*encodeingRate*(242);
-
-    symbols=bits/bitsPerSec;
-
 
-    return symbols*0.0000136; //guard interval + symbol duration = 0.0000136sec
+void
+RrOfdmaManager::NotifyStaDeassociated (uint16_t aid, Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << aid << address);
+  m_classifier.NotifyDisassociation (aid);
+  m_staTable.NotifyDisassociation (aid);
+  m_ulStaTable.NotifyDisassociation (aid);
+  m_ulBufferStatus.NotifyDisassociation (aid);
+  m_servedThroughput.NotifyDisassociation (aid);
+  m_ulServedThroughput.NotifyDisassociation (aid);
+  m_snrMap.NotifyDisassociation (aid);
+  m_staAid.erase (address);
+  m_backlog.Clear (aid);
+  m_candidateQueue.Remove (aid);
 }
 
-
-
-double RrOfdmaManager::averageChannelcapacity(int mcs1)
+void
+RrOfdmaManager::InitBacklog (uint16_t aid, Mac48Address address)
 {
-  double avgThrohput=0;
-  
-    for(unsigned int i=0;i<v_dataStaPair.size();i++)
+  m_staAid[address] = aid;
+  m_backlog.Clear (aid);
+  for (uint8_t tid = 0; tid < 8; tid++)
     {
-        avgThrohput+= (v_dataStaPair[i]/timeReq(v_dataStaPair[i],mcs1));
+      Ptr<QosTxop> txop = m_qosTxop[QosUtilsMapTidToAc (tid)];
+      for (Ptr<WifiMacQueue> queue : {txop->GetWifiMacQueue (), txop->GetBaManager ()->GetRetransmitQueue ()})
+        {
+          WifiMacQueue::ConstIterator it = queue->PeekByTidAndAddress (tid, address);
+          while (it != queue->end ())
+            {
+              m_backlog.NotifyEnqueue (aid, tid, (*it)->GetSize ());
+              if (m_bucketedCandidates)
+                {
+                  m_candidateQueue.Invalidate (aid);
+                }
+              it = queue->PeekByTidAndAddress (tid, address, ++it);
+            }
+        }
     }
-    return log2((avgThrohput/v_dataStaPair.size()));
-
-
-
 }
 
-WifiSpectrumBand
-RrOfdmaManager::GetBand (uint16_t bandWidth, uint8_t /*bandIndex*/)
+Time
+RrOfdmaManager::GetHolTimestamp (Mac48Address address, uint8_t tid)
 {
-  WifiSpectrumBand band;
-  band.first = 0;
-  band.second = 0;
-  return band;
+  Ptr<QosTxop> txop = m_qosTxop[QosUtilsMapTidToAc (tid)];
+  Time holTimestamp = Time::Max ();
+  for (Ptr<WifiMacQueue> queue : {txop->GetWifiMacQueue (), txop->GetBaManager ()->GetRetransmitQueue ()})
+    {
+      WifiMacQueue::ConstIterator it = queue->PeekByTidAndAddress (tid, address);
+      if (it != queue->end ())
+        {
+          holTimestamp = Min (holTimestamp, (*it)->GetTimeStamp ());
+        }
+    }
+  return holTimestamp;
 }
 
-
-
-void RrOfdmaManager::RuAlloc(int number_of_clients,uint16_t m_bw)
+uint32_t
+RrOfdmaManager::GetSendableBytes (uint16_t aid, Mac48Address address, uint8_t tid, uint32_t firstMpduSize)
 {
+  // the backlog may miss the MPDUs queued before the traces were connected
+  uint32_t bytes = std::max (m_backlog.GetBytes (aid, tid), firstMpduSize);
+  uint32_t mpdus = std::max<uint32_t> (m_backlog.GetMpdus (aid, tid), 1);
 
-  std::cout<<"\n Inside RU Alloca\n "<<number_of_clients;
-  //std::vector<int> RuSet;
-if (m_bw==20){
-  if(number_of_clients>0){
-switch(number_of_clients){
-  case 1:
-  finalRUAlloc.push_back(242);
-  break;
-
-  case 2:
-  finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(106);
- // RuSet.push_back(26);
-  break;
-
-  case 3:
-  finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(26);
-  break;
-
-  case 4:
-  finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(26);
-  break;
-
-  case 5:
-  finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
- break;
-
-case 6:
-  finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26); // other combination are also there
-  break;
-
-  case 7:
-  finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  break;
-
-  case 8:
-  finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  break;
-
-
-  default:
- for(int i=0;i<9;i++){
-  finalRUAlloc.push_back(26);
- }
-break;
-
-}
-
-}
-else{
-  std::cout<<"No client to allocate Resources";
-  
-
-}
-}
-else
-{if(number_of_clients>0){
-switch(number_of_clients){
-  case 1:
-  finalRUAlloc.push_back(484);
-  break;
-
-  case 2:
-  finalRUAlloc.push_back(242);
-  finalRUAlloc.push_back(242);
-  break;
-
-  case 3:
-  finalRUAlloc.push_back(242);
-  finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(106);
-//finalRUAlloc.push_back(26);
-  break;
-
-  case 4:
-finalRUAlloc.push_back(242);
-  finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(26);
-    break;
-
-  case 5:
-finalRUAlloc.push_back(242);
-  finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(26);
-  
- break;
-
-case 6:
-finalRUAlloc.push_back(242);
-  finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26); 
-
-
-  break;
-
-  case 7:
- finalRUAlloc.push_back(242);
-  finalRUAlloc.push_back(52);
-finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  
-  break;
-
-
- case 8:
-   finalRUAlloc.push_back(242);
-  finalRUAlloc.push_back(52);
-finalRUAlloc.push_back(52);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
- 
-  
-  break;
- case 9:
-   finalRUAlloc.push_back(106);
- finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(106);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  break;
- case 10:
-   finalRUAlloc.push_back(106);
- finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(52);
-finalRUAlloc.push_back(52);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  break;
- case 11:
-    finalRUAlloc.push_back(106);
- finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(52);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  break;
- case 12:
-    finalRUAlloc.push_back(106);
- finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  break;
- case 13:
-   finalRUAlloc.push_back(106);
- finalRUAlloc.push_back(52);
-finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  break;
- case 14:
-    finalRUAlloc.push_back(106);
- finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  break;
- case 15:
-finalRUAlloc.push_back(106);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  break;
- case 16:
-finalRUAlloc.push_back(52);
-finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  break;
-
-case 17:
-finalRUAlloc.push_back(52);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  finalRUAlloc.push_back(26);
-  break;
-
-
-  default:
- for(int i=0;i<18;i++){
-  finalRUAlloc.push_back(26);
- }
-break;
-
-}
-
-}
-else{
-  std::cout<<"No client to allocate Resources";
-  
-
-}
-
-}}
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-void RrOfdmaManager::mlwdf(){
-
-
-int lower=1,upper=11;
-int count=v_dataStaPair.size();
-
-  random_MCS.clear();
-for(int i=0;i<count;i++){
-  int num= (rand()%(upper-lower+1))+lower;
-  random_MCS.push_back(num);
-
-}
-uint16_t bw = m_low->GetPhy ()->GetChannelWidth ();
-
-
-  std::cout<<"inside Largest_Weighted_First before clearing vectors";
-
-
-
- std::cout<<"inside Largest_Weighted_First before calculating (loop)";
-
-for(unsigned int i = 0; i<v_dataStaPair.size();i++){
-  //get type of application and calucate what is the  Pr {W i > T i } £ d i
-  
-  double a_i_i=type_of_App(v_QosType[i]) ;   ////=log(delta)/Time
- 
-
-  double ratee=returnRate(10,bw);
-  std::cout<<"\n rateeeeee-------"<<ratee;
-  double avgThrohput=averageChannelcapacity(10);
-
-  final_cost=((v_dataStaPair[i]*a_i_i*ratee)/avgThrohput);
-
-  std::cout<<"\n Before dataStaPair1 inserting";
- dataStaPair1.push_back(std::make_pair(final_cost,2));
- 
- 
-}
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-std::cout<<"\n After While Loop in LWDF";
-//auto x=dataStaPair1.begin();
-std::cout<<"\n Before dataStaPair1 Loop fofr finalStaPairIndex";
-int zz = dataStaPair1.size();
-std::cout<<"\n"<<zz;
+  // no more MPDUs than the size of the Block Ack window can be sent
+  uint16_t baBufferSize = m_qosTxop[QosUtilsMapTidToAc (tid)]->GetBaBufferSize (address, tid);
+  if (mpdus > baBufferSize)
+    {
+      bytes = static_cast<uint32_t> (static_cast<uint64_t> (bytes) * baBufferSize / mpdus);
+    }
 
-int lol[zz];
-for(int i=0;i<zz;i++){
-	lol[i]=i;
+  // no more bytes than the maximum A-MPDU size can be sent
+  uint32_t maxAmpduSize = m_low->GetMpduAggregator ()->GetMaxAmpduSize (address, tid, WIFI_MOD_CLASS_HE);
+  return std::max (std::min (bytes, (maxAmpduSize > 0 ? maxAmpduSize : firstMpduSize)), firstMpduSize);
 }
 
-int countt=0;
-finalStaPairIndex.clear();
-for(int x=0;x<zz;x++)
+void
+RrOfdmaManager::NotifyMpduEnqueued (Ptr<const WifiMacQueueItem> item)
 {
-  finalStaPairIndex.push_back(std::make_pair(dataStaPair1[x].first,countt));
-  //zz--;
-
-  countt++;
-}
-
-
-std::cout<<"\n \n Before Sorting";
-int n=finalStaPairIndex.size();
-
-
-for(unsigned int i=0;i<finalStaPairIndex.size();i++){
-	std::cout<<"\n\n Data Before Sorting==================== "<<finalStaPairIndex[i].first<<"Second==========="<<finalStaPairIndex[i].second;
-	std::cout<<"\n\n LOL===="<<lol[i];
-}
-
-std::cout<<"\n finalStaPairIndex Size"<<n;
-
-
-    int counter, counter1,key1;
-    double key;  //i=counter, j=counter1
-    for (counter = 1; counter < n; counter++) 
-    {  
-        key = finalStaPairIndex[counter].first;  
-		key1= lol[counter];
-
-        counter1 = counter - 1;  
-        std::cout<<"\n \n inside insertion sort";
-        /* Move elements of arr[0..i-s1], that are  
-        greater than key, to one position ahead  
-        of their current position */
-        while (counter1 >= 0 && finalStaPairIndex[counter1].first < key) 
-        {  
-            finalStaPairIndex[counter1+1].first = finalStaPairIndex[counter1].first;
-            lol[counter1+1]=lol[counter1] ; 
-            counter1 = counter1 - 1;  
-
-
-        }  
-        finalStaPairIndex[counter1+1].first = key;  
-        lol[counter1+1]=key1;
-    }  
-
-
-std::cout<<"\n \n After  Sorting";
-for(unsigned int i=0;i<finalStaPairIndex.size();i++){
-	std::cout<<"\n\n Data After Sorting==================== "<<finalStaPairIndex[i].first<<"Second==========="<<finalStaPairIndex[i].second;
-	std::cout<<"\n\n LOL After Sorting=========="<<lol[i];
-}
-
-int noOfSTA=finalStaPairIndex.size();
-int temp2=noOfSTA;
-int temp4=noOfSTA;
-
-std::cout<<"\n \n Before RuAlloc Call ";
-RuAlloc(noOfSTA,bw); 
-for(unsigned int j=0;j<finalRUAlloc.size();j++){
-  std::cout<<"\n--- finalRUAlloc   "<<finalRUAlloc[j];
-
-
+  const WifiMacHeader& hdr = item->GetHeader ();
+  if (hdr.IsQosData ())
+    {
+      auto aidIt = m_staAid.find (hdr.GetAddr1 ());
+      if (aidIt != m_staAid.end ())
+        {
+          uint16_t aid = aidIt->second;
+          uint8_t tid = hdr.GetQosTid ();
+          // a frame for a TID that was not backlogged, or older than the HOL
+          // frames (e.g., a frame to retransmit), may exceed the bound of the
+          // station, which is then evaluated again at the next cycle
+          if (m_bucketedCandidates
+              && ((m_backlog.GetTids (aid) & (1 << tid)) == 0 || !m_candidateQueue.IsQueued (aid)
+                  || item->GetTimeStamp () < Simulator::Now ()))
+            {
+              m_candidateQueue.Invalidate (aid);
+            }
+          m_backlog.NotifyEnqueue (aid, tid, item->GetSize ());
+        }
+    }
 }
-int cc=0;
-
-for(unsigned int j=0;j<finalRUAlloc.size();j++){
-  
-  finalRUAlloc1.push_back(finalRUAlloc[j]);
 
+void
+RrOfdmaManager::NotifyMpduDequeued (Ptr<const WifiMacQueueItem> item)
+{
+  const WifiMacHeader& hdr = item->GetHeader ();
+  if (hdr.IsQosData ())
+    {
+      auto aidIt = m_staAid.find (hdr.GetAddr1 ());
+      if (aidIt != m_staAid.end ())
+        {
+          m_backlog.NotifyDequeue (aidIt->second, hdr.GetQosTid (), item->GetSize ());
+        }
+    }
 }
 
-while(temp4){
-
-int ss=lol[cc];
-//finalRUAlloc1.insert(finalRUAlloc1.begin()+ss,finalRUAlloc[cc]);i
-finalRUAlloc1[ss]=finalRUAlloc[cc];
-//std::cout<<"---finalRUAlloc1111--  "<<
-cc++;
-temp4--;
+void
+RrOfdmaManager::NotifyPsduForwardedDown (WifiPsduMap psduMap, WifiTxVector txVector)
+{
+  for (auto& psdu : psduMap)
+    {
+      if (!psdu.second->GetHeader (0).IsQosData () || psdu.second->GetAddr1 ().IsGroup ())
+        {
+          continue;
+        }
 
+      uint16_t aid = psdu.first;
+      if (txVector.GetPreambleType () != WIFI_PREAMBLE_HE_MU)
+        {
+          // PSDUs in SU PPDUs are not indexed by AID
+          auto aidIt = m_staAid.find (psdu.second->GetAddr1 ());
+          if (aidIt == m_staAid.end ())
+            {
+              continue;
+            }
+          aid = aidIt->second;
+        }
+      m_servedThroughput.NotifyServed (aid, psdu.second->GetSize (), Simulator::Now ());
+    }
 
+  if (m_adaptiveNStations && txVector.GetPreambleType () == WIFI_PREAMBLE_HE_MU)
+    {
+      // the time each user transmits data, given the rate of its RU and MCS
+      const auto& userInfoMap = txVector.GetHeMuUserInfoMap ();
+      uint64_t bytes = 0;
+      double totalTime = 0, maxTime = 0;
+      for (auto& psdu : psduMap)
+        {
+          auto userInfoIt = userInfoMap.find (psdu.first);
+          if (userInfoIt == userInfoMap.end ())
+            {
+              continue;
+            }
+          uint32_t rate = HeRateTable::GetRateKbps (userInfoIt->second.mcs.GetMcsValue (), txVector.GetChannelWidth (),
+                                                    txVector.GetGuardInterval (),
+                                                    HeRuTiling::GetSizeIndex (userInfoIt->second.ru.ruType));
+          if (rate > 0)
+            {
+              double time = psdu.second->GetSize () * 8.0 / rate;
+              totalTime += time;
+              maxTime = std::max (maxTime, time);
+            }
+          bytes += psdu.second->GetSize ();
+        }
+      if (maxTime > 0)
+        {
+          Time airtime = WifiPhy::CalculateTxDuration (psduMap, txVector, m_low->GetPhy ()->GetFrequency ());
+          m_maxUsers.NotifyPpdu (totalTime / (psduMap.size () * maxTime), bytes, airtime.GetNanoSeconds ());
+        }
+    }
 }
-for(unsigned int j=0;j<finalRUAlloc1.size();j++){
-  std::cout<<"\n--- finalRUAlloc111   "<<finalRUAlloc1[j];
 
+void
+RrOfdmaManager::NotifyMonitorSnifferRx (Ptr<const Packet> packet, uint16_t /* channelFreqMhz */,
+                                        WifiTxVector txVector, MpduInfo /* aMpdu */,
+                                        SignalNoiseDbm signalNoise)
+{
+  WifiMacHeader hdr;
+  packet->PeekHeader (hdr);
+  // CTS and Ack frames do not carry the address of the transmitter
+  if (hdr.GetAddr1 () != m_apMac->GetAddress () || hdr.IsCts () || hdr.IsAck ())
+    {
+      return;
+    }
 
-}
+  auto aidIt = m_staAid.find (hdr.GetAddr2 ());
+  if (aidIt == m_staAid.end ())
+    {
+      return;
+    }
+  Time now = Simulator::Now ();
 
+  if (m_snrAwarePlacement || m_ruPowerAllocation)
+    {
+      // an HE TB PPDU tells the SNR on the RU of the station, other PPDUs
+      // spanning the whole channel the SNR on all the positions
+      const HeRuTiling& tilings = HeRuTiling::Get (m_low->GetPhy ()->GetChannelWidth ());
+      double snr = signalNoise.signal - signalNoise.noise;
+      if (txVector.GetPreambleType () == WIFI_PREAMBLE_HE_TB)
+        {
+          const auto& userInfoMap = txVector.GetHeMuUserInfoMap ();
+          auto userInfoIt = userInfoMap.find (aidIt->second);
+          if (userInfoIt != userInfoMap.end ())
+            {
+              m_snrMap.NotifySnr (aidIt->second, tilings.GetMask (userInfoIt->second.ru), snr,
+                                  now.GetNanoSeconds ());
+            }
+        }
+      else if (txVector.GetChannelWidth () == tilings.GetChannelWidth ())
+        {
+          m_snrMap.NotifySnr (aidIt->second, tilings.GetChannelMask (), snr, now.GetNanoSeconds ());
+        }
+    }
 
+  if (!hdr.IsQosData ())
+    {
+      return;
+    }
 
-mappedRuAllocated.clear();
-std::cout<<"\n \n Before Mapped RU LOOP Call ";
-for (int i=0; i<noOfSTA; i++){
- //int ff=lol[i];
+  // the MAC header and the FCS are not included in the reported queue size
+  uint32_t bytes = packet->GetSize () - hdr.GetSerializedSize () - WIFI_MAC_FCS_LENGTH;
+  m_ulBufferStatus.NotifyReceived (aidIt->second, bytes, now.GetNanoSeconds ());
+  m_ulServedThroughput.NotifyServed (aidIt->second, bytes, now);
 
-switch(finalRUAlloc1[i]){
-  case 26: mappedRuAllocated.push_back(HeRu::RU_26_TONE);
-           break;
-  case 52: mappedRuAllocated.push_back(HeRu::RU_52_TONE);
-           break;
-  case 106: mappedRuAllocated.push_back(HeRu::RU_106_TONE);
-           break;
-  case 242: mappedRuAllocated.push_back(HeRu::RU_242_TONE);
-           break;
-  case 484: mappedRuAllocated.push_back(HeRu::RU_484_TONE);
-           break;
-  }
-  std::cout<<"\nMapping============================="<<mappedRuAllocated[i]<<"\n";
+  // in QoS Data frames sent by non-AP stations, the bit in the EOSP position
+  // indicates that the QoS Control field carries the Queue Size subfield
+  if (hdr.IsQosEosp ())
+    {
+      NS_LOG_DEBUG ("STA " << hdr.GetAddr2 () << " reported queue size " << +hdr.GetQosQueueSize ()
+                    << " for TID " << +hdr.GetQosTid ());
+      m_ulBufferStatus.NotifyQueueSize (aidIt->second, hdr.GetQosTid (), hdr.GetQosQueueSize (),
+                                        now.GetNanoSeconds ());
+    }
 }
 
-std::cout<<"\nmapping done\n";
+std::size_t
+RrOfdmaManager::ComputeUlTxVector (Ptr<const WifiMacQueueItem> mpdu, Time maxDuration)
+{
+  NS_LOG_FUNCTION (this << maxDuration);
 
+  Time now = Simulator::Now ();
+  m_ulStaTable.ClearCandidates ();
+  Ptr<WifiMacQueueItem> item = Copy (mpdu);
 
-std::cout<<"\n\n before staAllocated1 check how many m_staInfo there"<<m_staInfo.size();
-int temp3=0;
-staAllocated1.clear();
+  for (auto& sta : m_apMac->GetStaList ())
+    {
+      // stations that never reported their buffer status are solicited to send UlPsduSize bytes
+      bool known = m_ulBufferStatus.IsKnown (sta.first);
+      uint32_t bytes = (known ? m_ulBufferStatus.GetBytes (sta.first) : m_ulPsduSize);
+      if (bytes == 0)
+        {
+          continue;
+        }
+      uint8_t tid = (known ? m_ulBufferStatus.GetTid (sta.first) : 0);
+
+      // the MCS selected by the rate manager for the downlink is used as an
+      // estimate of the MCS the station can use in the uplink
+      item->GetHeader ().SetAddr1 (sta.second);
+      WifiMode mode = m_low->GetDataTxVector (item).GetMode ();
+      uint8_t mcs = (mode.GetModulationClass () == WIFI_MOD_CLASS_HE ? mode.GetMcsValue () : 0);
+
+      NS_LOG_DEBUG ("UL candidate STA (MAC=" << sta.second << ", AID=" << sta.first << ") buffer="
+                    << bytes << (known ? "" : " (unknown)") << " MCS=" << +mcs);
+      m_ulStaTable.AddCandidate (sta.first, sta.second, tid, bytes, m_classifier.GetClass (sta.first, tid), mcs,
+                                 m_ulBufferStatus.GetWaitingSince (sta.first),
+                                 m_ulServedThroughput.GetStaThroughput (sta.first, now) / 1e6);
+    }
 
-auto checking1=m_staInfo.begin();
+  if (m_ulStaTable.GetCandidates ().empty ())
+    {
+      NS_LOG_DEBUG ("No station has buffered frames");
+      return 0;
+    }
 
-  while(checking1!=m_staInfo.end()){
-          std::cout<<"\n staAllocated1-- "<< checking1->first;
-    checking1++;
-  }
+  m_ulCore.SetChannel (m_low->GetPhy ()->GetChannelWidth (), m_low->GetPhy ()->GetGuardInterval ().GetNanoSeconds ());
+  m_ulCore.SetPolicy (m_policy);
+  double value = m_ulCore.Schedule (m_ulStaTable, now.GetNanoSeconds (), maxDuration.GetNanoSeconds (), m_nStations);
+  NS_LOG_DEBUG ("Selected UL RU allocation has value " << value);
 
-while(temp2){
-  auto startItt = m_staInfo.begin();
- int dd = lol[temp3];
- //std::cout<<"\n \nstartITT==="<<startItt->first;
- std::cout<<"\n\n dd=============="<<dd;
-      for(int i=0;i<dd;i++){
-        // if(finalStaPairIndex[i].second==count1){
-        //   staAllocated1.push_back(*startItt);
-        //   count1++;
-
-        //}
-        startItt++;
-        //break;
-      }
-      std::cout<<"\n \nstartITT==="<<startItt->first;
-      staAllocated1.push_back(*startItt);
-      temp3++;
-
-      temp2--;
+  m_ulTxVector = WifiTxVector ();
+  m_ulTxVector.SetPreambleType (WIFI_PREAMBLE_HE_MU);
+  m_ulTxVector.SetChannelWidth (m_low->GetPhy ()->GetChannelWidth ());
+  m_ulTxVector.SetGuardInterval (m_low->GetPhy ()->GetGuardInterval ().GetNanoSeconds ());
+  m_ulTxVector.SetTxPowerLevel (GetWifiRemoteStationManager ()->GetDefaultTxPowerLevel ());
 
+  for (auto aid : m_ulStaTable.GetAllocated ())
+    {
+      NS_LOG_DEBUG ("STA " << m_ulStaTable.GetAddress (aid) << " solicited in " << m_ulStaTable.GetRu (aid));
+      m_ulTxVector.SetHeMuUserInfo (aid, {m_ulStaTable.GetRu (aid), WifiPhy::GetHeMcs (m_ulStaTable.GetMcs (aid)), 1});
+    }
+  return m_ulStaTable.GetAllocated ().size ();
 }
 
+void
+RrOfdmaManager::mlwdf (void)
+{
+  NS_LOG_FUNCTION (this);
 
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+  m_core.SetChannel (m_low->GetPhy ()->GetChannelWidth (), m_low->GetPhy ()->GetGuardInterval ().GetNanoSeconds ());
+  m_core.SetPolicy (m_policy);
+  double value = m_core.Schedule (m_staTable, now, m_availableTime.GetNanoSeconds (), m_maxUsersPerPpdu);
+  NS_LOG_DEBUG ("Selected RU allocation has value " << value);
 
-
-
-
-
-auto checking=staAllocated1.begin();
-
-  while(checking!=staAllocated1.end()){
-          std::cout<<"\n staAllocated1-- "<< checking->first;
-    checking++;
-  }
-
-std::cout<<"\n \n After Sorting based Mac48Address and store in staAllocated1"<<staAllocated1.size();
-
-
-  
+  if (SCHEDULER_TRACE_ENABLED (m_trace, SchedulerTrace::CANDIDATES))
+    {
+      for (auto aid : m_staTable.GetCandidates ())
+        {
+          m_trace.WriteCandidate (now, aid, m_staTable.GetWeights ()[aid], m_staTable.GetMcs (aid));
+        }
+    }
+  for (auto aid : m_staTable.GetAllocated ())
+    {
+      NS_LOG_DEBUG ("STA " << m_staTable.GetAddress (aid) << " HOL delay=" << m_staTable.GetHolDelay (aid)
+                    << " weight=" << m_staTable.GetWeights ()[aid] << " RU=" << m_staTable.GetRu (aid));
+    }
 }
 
-
-
-
-
-
-
-
-
-
-
 ////////////////////////////////////////////////COMPUTE DL OFDMA/////////////////////////////////////////////////////////
 OfdmaManager::DlOfdmaInfo
 RrOfdmaManager::ComputeDlOfdmaInfo (void)
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_staInfo.empty ())
+  const std::vector<uint16_t>& candidates = m_staTable.GetCandidates ();
+  const std::vector<uint16_t>& allocated = m_staTable.GetAllocated ();
+
+  if (candidates.empty ())
     {
       return DlOfdmaInfo ();
     }
@@ -1362,36 +1251,31 @@ RrOfdmaManager::ComputeDlOfdmaInfo (void)
 //   uint16_t bw = m_bw;   // for TESTING only
 
   // compute how many stations can be granted an RU and the RU size
-  std::size_t nRusAssigned = m_staInfo.size ();
-std::cout<<"m_sta_info size: ComputeDlOfdmaInfo "<<m_staInfo.size ()<<"\n";
+  std::size_t nRusAssigned = candidates.size ();
+  NS_LOG_DEBUG (candidates.size () << " candidate stations");
   
 
 
 
 
 
-HeRu::RuType ruType ;
+HeRu::RuType ruType = HeRu::RU_26_TONE;
 
-if(v_dataStaPair.size()>1){
+if(candidates.size()>1){
   //call your function
   
 mlwdf();
 
-  nRusAssigned=finalRUAlloc.size();
-  std::cout<<"\nmin ru alloc size assigned to nru assigned"<<nRusAssigned<<"\n";
+  nRusAssigned=allocated.size();
 
   if(nRusAssigned==0) //in case no feasible ru allocation for current input exists.
   {
-    std::cout<<"if(nRusAssigned==0) \n";
-    //std::size_t nRusAs = m_staInfo.size ();
-    nRusAssigned = m_staInfo.size ();
+    NS_LOG_DEBUG ("No feasible RU allocation: falling back to RUs of equal size");
+    nRusAssigned = candidates.size ();
     ruType = GetNumberAndTypeOfRus (bw, nRusAssigned);
   }
 }else{
-  std::cout<<"inside else";
-  std::cout<<"if(dataStaPair.size()>1): false, in else case\n";
-  //std::size_t nRusAs = m_staInfo.size ();
-  nRusAssigned = m_staInfo.size ();
+  nRusAssigned = candidates.size ();
   ruType = GetNumberAndTypeOfRus (bw, nRusAssigned);
 }
 
@@ -1399,67 +1283,46 @@ mlwdf();
 
 ///////////////////////////////////////////////////////
 
-//std::cout<<nRusAssigned << " stations are being assigned a " << ruType << " RU\n";
- // NS_LOG_DEBUG (nRusAssigned << " stations are being assigned a " << ruType << " RU");
+  NS_LOG_DEBUG (nRusAssigned << " stations are being assigned an RU");
 
-std::cout<<"\n before Intilaizing DlOfdmaInfo dlOfdmaInfo\n";
   DlOfdmaInfo dlOfdmaInfo;
-  auto staInfoIt = m_staInfo.begin (); // iterator over the list of candidate receivers
 
-  if(staAllocated1.empty()){
+  if(allocated.empty()){
     for (std::size_t i = 0; i < nRusAssigned; i++){
       
-      std::cout<<"\n staAllocated1 is empty"<<i;
-      NS_ASSERT (staInfoIt != m_staInfo.end ());
-      dlOfdmaInfo.staInfo.insert (*staInfoIt);
-      staInfoIt++;
+      NS_ASSERT (i < candidates.size ());
+      uint16_t aid = candidates[i];
+      dlOfdmaInfo.staInfo.insert (std::make_pair (m_staTable.GetAddress (aid),
+                                                  DlPerStaInfo {aid, m_staTable.GetTid (aid)}));
     }
-  }else if(staAllocated1.size()>0){
-        auto sti = staAllocated1.begin (); // iterator over the list of candidate receivers
-        for (std::size_t i = 0; i < finalRUAlloc.size(); i++){
-           std::cout<<"\n staAllocated1 is > 0"<<i;
-        	NS_ASSERT (sti != staAllocated1.end ());
-          dlOfdmaInfo.staInfo.insert (*sti);
-
-          auto mp=dlOfdmaInfo.staInfo.begin();
-          while(mp!=dlOfdmaInfo.staInfo.end()){
-          	std::cout<<"\n  Dlofdma after insert "<<mp->first;
-          	mp++;
-          }
-
-          std::cout<<"\n sti--"<<sti->first;
-          sti++;
+  }else{
+      for (auto aid : allocated)
+        {
+          dlOfdmaInfo.staInfo.insert (std::make_pair (m_staTable.GetAddress (aid),
+                                                      DlPerStaInfo {aid, m_staTable.GetTid (aid)}));
         }
     }
   
-    std::cout<<"\n After DlOfdmaInfo initialization\n";
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////////////
-  // if not all the stations are assigned an RU, the first station to serve next
-  // time is the first one that was not served this time
-  if (nRusAssigned < m_staInfo.size ())
+  // if the candidates were assigned RUs of equal size and not all of them got
+  // one, the first station to visit next time is the first one not served
+  if (allocated.empty () && nRusAssigned < candidates.size ())
     {
-      NS_ASSERT (staInfoIt != m_staInfo.end ());
-      m_startStation = staInfoIt->second.aid;
-      std::cout<<"Next station to serve has AID=" << m_startStation<<"\n";
+      m_startStation = candidates[nRusAssigned];
     }
-
-  auto firstSTA = m_staInfo.begin (); 
-  m_startStation=firstSTA->second.aid; ////// Thinkkkkkk
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
   NS_LOG_DEBUG ("Next station to serve has AID=" << m_startStation);
 
 
-    std::cout<<"\n before InitTxVectorAndParams func call\n";
 
 
 
   InitTxVectorAndParams (dlOfdmaInfo.staInfo, ruType, m_dlMuAckSequence);
   dlOfdmaInfo.params = m_txParams;
 
-    std::cout<<"\n after InitTxVectorAndParams func call\n";
 
 
  
@@ -1467,58 +1330,35 @@ std::cout<<"\n before Intilaizing DlOfdmaInfo dlOfdmaInfo\n";
   if (ruType == HeRu::RU_2x996_TONE)
     {
       HeRu::RuSpec ru = {true, ruType, 1};
-      NS_LOG_DEBUG ("STA " << m_staInfo.front ().first << " assigned " << ru);
-      m_txVector.SetRu (ru, m_staInfo.front ().second.aid);
+      NS_LOG_DEBUG ("STA " << m_staTable.GetAddress (candidates.front ()) << " assigned " << ru);
+      m_txVector.SetRu (ru, candidates.front ());
     }
   else
     {
-      std::vector<bool> primary80MHzSet {true};
+      // the primary 80 MHz segment, then the secondary one in a 160 MHz channel
+      const bool primary80MHzSet[] = {true, false};
+      std::size_t nSegments = 1;
 
       if (bw == 160)
         {
-          primary80MHzSet.push_back (false);
+          nSegments = 2;
           bw = 80;
         }
 
       auto mapIt = dlOfdmaInfo.staInfo.begin ();
-        if(mappedRuAllocated.size()!=0){
-        std::size_t ru26 = 0;
-        std::size_t ru52 = 0;
-        std::size_t ru106 = 0;
-        std::size_t ru242 = 0;
-        std::size_t ru484 = 0;
-          std::vector<int>::size_type len = mappedRuAllocated.size();
-          std::cout<<"\n mappedRuAllocated size="<<len;
-          for (unsigned i=0; i<len; i++){
-           HeRu::RuSpec ru;
-        switch(mappedRuAllocated[i]){
-          case HeRu::RU_26_TONE: ru26++;
-                     ru = {true, mappedRuAllocated[i],ru26};
-                   break;
-          case HeRu::RU_52_TONE: ru52++;
-                     ru = {true, mappedRuAllocated[i],ru52};
-                   break;
-          case HeRu::RU_106_TONE: ru106++;
-                     ru = {true, mappedRuAllocated[i],ru106};
-                   break;
-          case HeRu::RU_242_TONE: ru242++;
-                    ru = {true, mappedRuAllocated[i],ru242};
-                   break;
-          case HeRu::RU_484_TONE: ru484++;
-                    ru = {true, mappedRuAllocated[i],ru484};
-                   break;
-        default: break;
-          }
-            std::cout<<"\n STA ----" << mapIt->first << " assigned---- " << ru;
-           NS_LOG_DEBUG ("STA " << mapIt->first << " assigned " << ru);
-           m_txVector.SetRu (ru, mapIt->second.aid);
-           mapIt++;
-          }
+        if(!allocated.empty()){
+          // the RUs granted by the allocator, sorted by decreasing RU size
+          for (auto aid : allocated)
+            {
+              NS_LOG_DEBUG ("STA " << m_staTable.GetAddress (aid) << " assigned " << m_staTable.GetRu (aid));
+              m_txVector.SetRu (m_staTable.GetRu (aid), aid);
+            }
         }
         else{
 
-              for (auto primary80MHz : primary80MHzSet)
+              for (std::size_t segment = 0; segment < nSegments; segment++)
                 {
+                  bool primary80MHz = primary80MHzSet[segment];
                   for (std::size_t ruIndex = 1; ruIndex <= HeRu::m_heRuSubcarrierGroups.at ({bw, ruType}).size (); ruIndex++)
                     {
                       NS_ASSERT (mapIt != dlOfdmaInfo.staInfo.end ());
@@ -1530,8 +1370,33 @@ std::cout<<"\n before Intilaizing DlOfdmaInfo dlOfdmaInfo\n";
                 }
              }
 }
+  if (m_ruPowerAllocation)
+    {
+      AllocateRuPower ();
+    }
   dlOfdmaInfo.txVector = m_txVector;
 
+  if (SCHEDULER_TRACE_ENABLED (m_trace, SchedulerTrace::GRANTS))
+    {
+      int64_t now = Simulator::Now ().GetNanoSeconds ();
+      for (auto& userInfo : m_txVector.GetHeMuUserInfoMap ())
+        {
+          const HeRu::RuSpec& ru = userInfo.second.ru;
+          m_trace.WriteGrant (now, userInfo.first, m_staTable.GetWeight (userInfo.first),
+                              userInfo.second.mcs.GetMcsValue (),
+                              HeRateTable::GetRuTones (HeRuTiling::GetSizeIndex (ru.ruType)),
+                              ru.index, ru.primary80MHz);
+        }
+    }
+  if (m_decisions.IsEnabled ())
+    {
+      RecordDecision (candidates.size (), !allocated.empty ());
+    }
+  if (m_adaptiveNStations)
+    {
+      m_maxUsers.NotifyDecision (m_staTable, Simulator::Now ().GetNanoSeconds ());
+    }
+
   if (m_txParams.GetDlMuAckSequenceType () == DlMuAckSequenceType::DL_MU_BAR
       || m_txParams.GetDlMuAckSequenceType () == DlMuAckSequenceType::DL_AGGREGATE_TF)
     {
@@ -1544,49 +1409,60 @@ std::cout<<"\n before Intilaizing DlOfdmaInfo dlOfdmaInfo\n";
       SetTargetRssi (dlOfdmaInfo.trigger);
     }
 
-finalRUAlloc.clear();
-finalRUAlloc1.clear();
-mappedRuAllocated.clear();
-
-
-  std::cout<<"\nsetting mcs before\n";
-
-// if(random_MCS.size()>1){
-//   std::cout<<"\nsetting mcs inside loop\n";
-// unsigned int x=0;
-// auto userInfoMap = dlOfdmaInfo.txVector.GetHeMuUserInfoMap ();
-// for (auto& userInfo : userInfoMap)
-//     {
-//       uint8_t mcs = random_MCS.at(x);
-//       NS_LOG_FUNCTION("MCS"<<mcs);
-//  dlOfdmaInfo.txVector.SetHeMuUserInfo (userInfo.first, {userInfo.second.ru,
-//                                                      WifiPhy::GetHeMcs (mcs),
-//                                                      userInfo.second.nss});
-// x++;
-//     }
-//   random_MCS.clear();
-//  }
-  
-
-  std::cout<<"\nsetting mcs after\n";
-staAllocated1.clear();
-
-
+  return dlOfdmaInfo;
+}
 
+void
+RrOfdmaManager::AllocateRuPower (void)
+{
+  NS_LOG_FUNCTION (this);
 
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+  const HeRuTiling& tilings = HeRuTiling::Get (m_low->GetPhy ()->GetChannelWidth ());
 
-// auto userInfoMap = dlMuTxVector.GetHeMuUserInfoMap ();
+  m_ruPower.Clear ();
+  for (auto aid : m_staTable.GetAllocated ())
+    {
+      const HeRu::RuSpec& ru = m_staTable.GetRu (aid);
+      double snr = std::numeric_limits<double>::quiet_NaN ();
+      m_snrMap.GetRuSnr (aid, tilings.GetMask (ru), now, snr);
+      m_ruPower.AddUser (aid, HeRateTable::GetRuTones (HeRuTiling::GetSizeIndex (ru.ruType)),
+                         m_staTable.GetWeight (aid), snr);
+    }
+  m_ruPower.Allocate (m_maxPsdOffset);
 
-//   for (auto& userInfo : userInfoMap)
-//     {
-//       uint8_t mcs = std::min (userInfo.second.mcs.GetMcsValue (), maxMcs);
-//       dlMuTxVector.SetHeMuUserInfo (userInfo.first, {userInfo.second.ru,
-//                                                      WifiPhy::GetHeMcs (mcs),
-//                                                      userInfo.second.nss});
-//     }
+  // the MCS of each station is left as the RU allocator sized the RU for it,
+  // since the PHY transmits with a uniform PSD
+  for (auto aid : m_staTable.GetAllocated ())
+    {
+      NS_LOG_DEBUG ("STA " << m_staTable.GetAddress (aid) << " RU=" << m_staTable.GetRu (aid)
+                    << " power offset=" << m_ruPower.GetOffsetDb (aid) << "dB");
+    }
+}
 
+void
+RrOfdmaManager::RecordDecision (std::size_t nCandidates, bool allocated)
+{
+  m_decisions.AddDecision (Simulator::Now ().GetNanoSeconds (), nCandidates,
+                           allocated ? m_core.GetAllocator ().GetComposition () : HeRuTiling::Composition {},
+                           allocated ? m_core.GetAllocator ().GetAirtime () : 0);
 
-  return dlOfdmaInfo;
+  // the stations granted an RU first, then the other candidates while there is room
+  const auto& userInfoMap = m_txVector.GetHeMuUserInfoMap ();
+  for (auto& userInfo : userInfoMap)
+    {
+      m_decisions.AddUser ({m_staTable.GetWeight (userInfo.first), userInfo.second.ru, userInfo.first,
+                            userInfo.second.mcs.GetMcsValue (), true,
+                            m_ruPowerAllocation ? m_ruPower.GetOffsetDb (userInfo.first) : 0.0});
+    }
+  for (auto aid : m_staTable.GetCandidates ())
+    {
+      if (userInfoMap.find (aid) == userInfoMap.end ()
+          && !m_decisions.AddUser ({m_staTable.GetWeight (aid), HeRu::RuSpec (), aid, m_staTable.GetMcs (aid), false, 0.0}))
+        {
+          break;
+        }
+    }
 }
 
 CtrlTriggerHeader
@@ -1612,8 +1488,8 @@ RrOfdmaManager::GetTriggerFrameHeader (WifiTxVector dlMuTxVector, uint8_t maxMcs
 OfdmaManager::UlOfdmaInfo
 RrOfdmaManager::ComputeUlOfdmaInfo (void)
 {
-  CtrlTriggerHeader trigger (TriggerFrameType::BASIC_TRIGGER, m_txVector);
-  trigger.SetUlLength (m_txVector.GetLength ());
+  CtrlTriggerHeader trigger (TriggerFrameType::BASIC_TRIGGER, m_ulTxVector);
+  trigger.SetUlLength (m_ulTxVector.GetLength ());
   SetTargetRssi (trigger);
 
   UlOfdmaInfo ulOfdmaInfo;
@@ -25,26 +25,42 @@
 #define RR_OFDMA_MANAGER_H
 
 #include "ofdma-manager.h"
-#include "interference-helper.h"
 #include "wifi-phy.h"
-#include "yans-wifi-phy.h"
-#include <list>
+#include "backlog-index.h"
+#include "candidate-queue.h"
+#include "decision-log.h"
+#include "he-rate-table.h"
+#include "max-users-controller.h"
+#include "ofdma-scheduler-core.h"
+#include "ru-power-allocator.h"
+#include "ru-snr-map.h"
+#include "scheduler-arena.h"
+#include "scheduler-trace.h"
+#include "served-throughput-tracker.h"
+#include "sta-state-table.h"
+#include "traffic-classifier.h"
+#include "ul-buffer-status.h"
+#include <map>
+#include <vector>
 
 namespace ns3 {
 
 /**
  * \ingroup wifi
  *
- * RrOfdmaManager is a simple OFDMA Manager that indicates to perform a DL OFDMA
- * transmission if the AP has frames to transmit to at least one station.
- * RrOfdmaManager assigns RUs of equal size (in terms of tones) to stations to
- * which the AP has frames to transmit belonging to the AC who gained access to the
- * channel or higher. The maximum number of stations that can be granted an RU
- * is configurable. Associated stations are served in a round robin fashion.
+ * RrOfdmaManager is an OFDMA Manager that indicates to perform a DL OFDMA
+ * transmission if the AP has frames to transmit to at least one station. The
+ * candidates are the stations to which the AP has frames to transmit belonging
+ * to the AC who gained access to the channel or higher. They are weighted by
+ * the configured scheduling policy (M-LWDF by default) and OfdmaSchedulerCore
+ * grants RUs, possibly of different sizes, to the stations with the largest
+ * weights. The maximum number of stations that can be granted an RU is
+ * configurable. If no RU allocation is feasible, RUs of equal size (in terms
+ * of tones) are assigned to the first candidates, which are visited in a
+ * round robin fashion starting from the first station not served the last
+ * time. After a DL OFDMA transmission, UL OFDMA transmissions can be solicited
+ * from the stations with buffered frames.
  */
-//class WifiPhy;
-
-
 class RrOfdmaManager : public OfdmaManager
 {
 public:
@@ -56,6 +72,23 @@ public:
   RrOfdmaManager ();
   virtual ~RrOfdmaManager ();
 
+  /**
+   * Set the M-LWDF traffic class of the given station.
+   *
+   * \param address the MAC address of the station
+   * \param trafficClass the traffic class (see TrafficClassifier)
+   */
+  void SetStationClass (Mac48Address address, uint8_t trafficClass);
+  /**
+   * Print the most recent scheduling decisions (see the DecisionLogSize attribute).
+   *
+   * \param os the output stream
+   */
+  void DumpDecisions (std::ostream& os) const;
+
+protected:
+  virtual void DoDispose (void);
+
 private:
   /**
    * Select the format of the next transmission, assuming that the AP gained
@@ -94,16 +127,22 @@ private:
    */
   HeRu::RuType GetNumberAndTypeOfRus (uint16_t bandwidth, std::size_t& nStations) const;
 
+  /// Receiver stations of a DL MU PPDU, held in the scratch arena of the scheduling cycle
+  typedef std::map<Mac48Address, DlPerStaInfo, std::less<Mac48Address>,
+                   ArenaAllocator<std::pair<const Mac48Address, DlPerStaInfo>>> ScratchStaList;
+
   /**
    * Compute the TX vector and the TX params for a DL MU transmission assuming
    * the given list of receiver stations, the given RU type and the given type
    * of acknowledgment sequence.
    *
+   * \tparam StaList a map of DlPerStaInfo indexed by MAC address
    * \param staList the list of receiver stations for the DL MU transmission
    * \param ruType the RU type
    * \param dlMuAckSequence the ack sequence type
    */
-  void InitTxVectorAndParams (std::map<Mac48Address, DlPerStaInfo> staList,
+  template <class StaList>
+  void InitTxVectorAndParams (const StaList& staList,
                               HeRu::RuType ruType, DlMuAckSequenceType dlMuAckSequence);
 
   /**
@@ -116,126 +155,200 @@ private:
    */
   CtrlTriggerHeader GetTriggerFrameHeader (WifiTxVector dlMuTxVector, uint8_t maxMcs);
 
+  /**
+   * Connect the trace sources the scheduler relies upon. Called the first time
+   * the scheduler is invoked, when the MAC and the PHY have been set up.
+   */
+  void ConnectTraces (void);
+  /**
+   * Update the served throughput statistics upon the transmission of PSDUs.
+   *
+   * \param psduMap the PSDUs forwarded down to the PHY
+   * \param txVector the TX vector used to transmit the PSDUs
+   */
+  void NotifyPsduForwardedDown (WifiPsduMap psduMap, WifiTxVector txVector);
+  /**
+   * Notify that a station has associated with the AP.
+   *
+   * \param aid the AID of the station
+   * \param address the MAC address of the station
+   */
+  void NotifyStaAssociated (uint16_t aid, Mac48Address address);
+  /**
+   * Notify that a station has disassociated from the AP.
+   *
+   * \param aid the AID of the station
+   * \param address the MAC address of the station
+   */
+  void NotifyStaDeassociated (uint16_t aid, Mac48Address address);
+  /**
+   * Map the given station to its AID and account for the frames already
+   * queued for the station in the backlog index.
+   *
+   * \param aid the AID of the station
+   * \param address the MAC address of the station
+   */
+  void InitBacklog (uint16_t aid, Mac48Address address);
+  /**
+   * Update the backlog index upon the enqueue of an MPDU.
+   *
+   * \param item the enqueued MPDU
+   */
+  void NotifyMpduEnqueued (Ptr<const WifiMacQueueItem> item);
+  /**
+   * Update the backlog index when an MPDU leaves the queue (dequeued or expired).
+   *
+   * \param item the MPDU
+   */
+  void NotifyMpduDequeued (Ptr<const WifiMacQueueItem> item);
+  /**
+   * Get the bytes that can be sent to the given station in a single A-MPDU,
+   * i.e., the bytes queued for the given TID, limited by the size of the
+   * Block Ack window and by the maximum A-MPDU size.
+   *
+   * \param aid the AID of the station
+   * \param address the MAC address of the station
+   * \param tid the TID
+   * \param firstMpduSize the size of the first MPDU queued for the station
+   * \return the bytes that can be sent to the station
+   */
+  uint32_t GetSendableBytes (uint16_t aid, Mac48Address address, uint8_t tid, uint32_t firstMpduSize);
+  /**
+   * Get the timestamp of the oldest frame queued for the given station and TID,
+   * in the EDCA queue or in the retransmit queue of the Block Ack manager.
+   *
+   * \param address the MAC address of the station
+   * \param tid the TID
+   * \return the timestamp of the oldest frame, or Time::Max () if none is queued
+   */
+  Time GetHolTimestamp (Mac48Address address, uint8_t tid);
+  /**
+   * Update the SNR map with the frames received from the stations and their
+   * buffer status with the QoS Data frames.
+   *
+   * \param packet the received MPDU
+   * \param channelFreqMhz the frequency in MHz
+   * \param txVector the TX vector of the received PPDU
+   * \param aMpdu the A-MPDU information
+   * \param signalNoise the signal and noise power
+   */
+  void NotifyMonitorSnifferRx (Ptr<const Packet> packet, uint16_t channelFreqMhz, WifiTxVector txVector,
+                               MpduInfo aMpdu, SignalNoiseDbm signalNoise);
+  /**
+   * Select the stations to solicit for an UL OFDMA transmission and their RUs
+   * based on their buffer status, and compute the TX vector of the HE TB PPDU
+   * (the Length is set by the caller).
+   *
+   * \param mpdu the MPDU the AP intended to transmit
+   * \param maxDuration the maximum duration of the HE TB PPDU
+   * \return the number of stations that are solicited
+   */
+  std::size_t ComputeUlTxVector (Ptr<const WifiMacQueueItem> mpdu, Time maxDuration);
+  /**
+   * Spread the power of the DL MU PPDU across the RUs granted by the last
+   * decision, given the weight of the stations and their SNR on their RU. The
+   * offsets are recorded in the decision log only.
+   */
+  void AllocateRuPower (void);
+  /**
+   * Record the decision just taken by ComputeDlOfdmaInfo in the decision log.
+   *
+   * \param nCandidates the number of candidate stations
+   * \param allocated whether the RUs were selected by the RU allocator
+   */
+  void RecordDecision (std::size_t nCandidates, bool allocated);
+  /**
+   * Add the given station to the candidates if the AP has a frame for it that
+   * meets the size and time constraints, with the TID tried first.
+   *
+   * \param aid the AID of the station
+   * \param currTid the TID of the MPDU the AP intended to transmit
+   * \param primaryAc the primary AC
+   * \param ruType the RU type used to check the constraints
+   * \param txopLimit the time available in the TXOP, if any
+   * \param now the current time
+   * \return true if the station has been added to the candidates
+   */
+  bool EvaluateCandidate (uint16_t aid, uint8_t currTid, AcIndex primaryAc, HeRu::RuType ruType,
+                          Time txopLimit, Time now);
+  /**
+   * Examine the stations in m_candidateQueue by decreasing bound until
+   * m_maxUsersPerPpdu candidates are found whose weight is at least the bound of
+   * the remaining stations, then queue the examined stations again.
+   *
+   * \param currTid the TID of the MPDU the AP intended to transmit
+   * \param primaryAc the primary AC
+   * \param ruType the RU type used to check the constraints
+   * \param txopLimit the time available in the TXOP, if any
+   * \param now the current time
+   */
+  void SelectBucketedCandidates (uint8_t currTid, AcIndex primaryAc, HeRu::RuType ruType,
+                                 Time txopLimit, Time now);
+  /**
+   * Queue again in m_candidateQueue the stations in m_popped that are still
+   * backlogged, with the largest bound of the oldest frames of their backlogged
+   * TIDs.
+   *
+   * \param now the current time
+   */
+  void RequeueCandidates (Time now);
+
   uint8_t m_nStations;                                         //!< Number of stations/slots to fill
+  bool m_adaptiveNStations;                                    //!< whether m_maxUsersPerPpdu is retuned online
+  std::size_t m_maxUsersPerPpdu;                               //!< stations that can be granted an RU in the DL MU PPDU
+  Time m_targetHolDelay;                                       //!< target HOL delay percentile
+  uint32_t m_adaptationEpoch;                                  //!< decisions between two adjustments
+  MaxUsersController m_maxUsers;                               //!< retunes m_maxUsersPerPpdu
   uint16_t m_startStation;                                     //!< AID of the station to start with
-  std::list<std::pair<Mac48Address, DlPerStaInfo>> m_staInfo;  //!< Info for the stations the AP has frames to send to
   WifiTxVector m_txVector;                                     //!< TX vector
   MacLowTransmissionParameters m_txParams;                     //!< TX params
   DlMuAckSequenceType m_dlMuAckSequence;                       //!< DL MU ack sequence type
   UlMuAckSequenceType m_ulMuAckSequence;                       //!< UL MU ack sequence type
   bool m_forceDlOfdma;                                         //!< return DL_OFDMA even if no DL MU PPDU was built
-  bool m_enableUlOfdma;     
-
-                                 //!< enable the scheduler to also return UL_OFDMA
-  uint32_t m_ulPsduSize;
-                                       //!< the size in byte of the solicited PSDU
-  uint16_t m_bw;              
-std::vector<std::vector<int> > RU20{
-    {242},
-    {106,106,26},
-    {106,52,52,26},
-    {106,52,26,26,26},
-    {52,52,52,52,26},
-    {106,26,26,26,26,26},
-    {52,52,52,26,26,26},
-    {52,52,26,26,26,26,26},
-    {52,26,26,26,26,26,26,26},
-    {26,26,26,26,26,26,26,26,26}
-  };
-
-std::vector<std::vector<int> > RU40{
-    {484},
-
-    {242,242},
-
-    {242,106,106,26},
-
-    {242,106,52,52,26},
-    {106,106,106,106,52},
-
-    {242,106,52,26,26,26},
-    {242,52,52,52,52,26},
-    {106,106,106,106,26,26},
-    {106,106,106,52,52,52},
-
-    {242,106,26,26,26,26,26},
-    {242,52,52,52,26,26,26},
-    {106,106,106,52,52,26,26},
-    {106,106,52,52,52,52,52},
-    
-    {242,52,52,26,26,26,26,26},
-    {106,106,106,52,26,26,26,26},
-    {106,106,52,52,52,52,26,26},
-    {106,52,52,52,52,52,52,52},
-
-    
-    {242,52,26,26,26,26,26,26,26},
-
-    {242,26,26,26,26,26,26,26,26,26},
-
-    {106,106,106,26,26,26,26,26,26},
-    {106,106,52,52,52,26,26,26,26},
-    {106,106,52,52,26,26,26,26,26,26},
-    {106,106,52,26,26,26,26,26,26,26,26},
-    {106,106,26,26,26,26,26,26,26,26,26,26},
-
-    {106,52,52,52,52,52,52,26,26},
-    {106,52,52,52,52,52,26,26,26,26},
-    {106,52,52,52,52,26,26,26,26,26,26},
-    {106,52,52,52,26,26,26,26,26,26,26,26},
-    {106,52,52,26,26,26,26,26,26,26,26,26,26},
-    {106,52,26,26,26,26,26,26,26,26,26,26,26,26},
-    {106,26,26,26,26,26,26,26,26,26,26,26,26,26,26},
-    {52,52,52,52,52,52,52,52,26,26},
-    {52,52,52,52,52,52,52,26,26,26,26},
-    {52,52,52,52,52,52,26,26,26,26,26,26},
-    {52,52,52,52,52,26,26,26,26,26,26,26,26},
-    {52,52,52,52,26,26,26,26,26,26,26,26,26,26},
-    {52,52,52,26,26,26,26,26,26,26,26,26,26,26,26},
-    {52,52,26,26,26,26,26,26,26,26,26,26,26,26,26,26},
-    {52,26,26,26,26,26,26,26,26,26,26,26,26,26,26,26,26},
-    {26,26,26,26,26,26,26,26,26,26,26,26,26,26,26,26,26,26}
-  };
-
-
-InterferenceHelper m_interference;
- //WifiPhy powww; 
-
-//Reshan
-
-//const YansWifiPhy powww;  
-WifiSpectrumBand GetBand (uint16_t bandWidth, uint8_t bandIndex = 0);
-
-  std::list<std::pair<uint32_t, uint16_t>> dataStaPair;  
-  std::vector<std::pair<double, uint16_t>> dataStaPair1;
-   std::vector<std::pair<double, int>> finalStaPairIndex;
-   std::list<std::pair<int, uint16_t>> QosType;
-   std::vector<uint32_t> v_dataStaPair;
-   std::vector<double> v_powerLevel;
-   std::vector<int> v_QosType;
-   double final_cost;
-   std::vector<int> random_MCS;
-std::vector<int> selective_MCS;
-
-RxSignalInfo rxSnr;
-                                                                //!< for TESTING only
-std::vector<int> finalRUAlloc;
-std::vector<int> finalRUAlloc1;
-std::vector<std::pair<Mac48Address, DlPerStaInfo>> staAllocated;
-std::list<std::pair<Mac48Address, DlPerStaInfo>> staAllocated1;
-
-//std::list<std::pair<Mac48Address, DlPerStaInfo>> m_staInfo;
-
-std::vector<HeRu::RuType> mappedRuAllocated;
-void RuAlloc(int number_of_clients,uint16_t m_bw);
-void mapped_He_RU(std::vector<int> mapped);
-double type_of_App(int type_of_Application);
-void mlwdf();
-double averageChannelcapacity(int mcs1);
-double timeReq(uint32_t dataSize,int mcs);
-const YansWifiPhy powww;
-
+  bool m_enableUlOfdma;                                        //!< enable the scheduler to also return UL_OFDMA
+  uint32_t m_ulPsduSize;                                       //!< the size in byte of the solicited PSDU
+  uint16_t m_bw;                                               //!< channel width (for testing only)
+  Time m_throughputTimeConstant;                               //!< time constant of the served throughput averages
+  double m_minServedThroughput;                                //!< lowest served throughput (bit/s) of a station
+  ServedThroughputTracker m_servedThroughput;                  //!< average throughput served to each station
+  bool m_tracesConnected;                                      //!< whether ConnectTraces has been called
+  SchedulingPolicyType m_policy;                               //!< policy used to weight the candidates
+  std::string m_classMapFile;                                  //!< file with the traffic class of stations
+  TrafficClassifier m_classifier;                              //!< traffic class of each station
+  uint8_t m_traceLevel;                                        //!< highest level of the written trace records
+  std::string m_traceFile;                                     //!< name of the scheduler trace file
+  SchedulerTrace m_trace;                                      //!< binary trace of the scheduler decisions
+  uint32_t m_decisionLogSize;                                  //!< number of decisions kept in the decision log
+  std::string m_decisionDumpFile;                              //!< file the decision log is dumped to at the end
+  DecisionLog m_decisions;                                     //!< the most recent scheduling decisions
+  std::map<Mac48Address, uint16_t> m_staAid;                   //!< AID of the associated stations
+  BacklogIndex m_backlog;                                      //!< stations and TIDs the AP has frames for
+  UlBufferStatus m_ulBufferStatus;                             //!< bytes buffered by each station for the UL
+  ServedThroughputTracker m_ulServedThroughput;                //!< average UL throughput of each station
+  StaStateTable m_ulStaTable;                                  //!< UL scheduler state of each station
+  OfdmaSchedulerCore m_ulCore;                                 //!< UL weights, ranking and RU allocation
+  WifiTxVector m_ulTxVector;                                   //!< TX vector of the solicited HE TB PPDU
+  bool m_snrAwarePlacement;                                    //!< whether RUs are placed by SNR
+  Time m_snrMaxAge;                                            //!< age beyond which an SNR sample is discarded
+  RuSnrMap m_snrMap;                                           //!< SNR of each station on each RU position
+  bool m_ruPowerAllocation;                                    //!< whether the power is allocated per RU
+  double m_maxPsdOffset;                                       //!< largest power offset (dB) of an RU
+  uint32_t m_planCacheSize;                                    //!< number of memoized RU allocations
+  bool m_fixedPointWeights;                                    //!< whether M-LWDF is computed in fixed point
+  bool m_bucketedCandidates;                                   //!< whether stations are examined by weight bound
+  Time m_bucketHorizon;                                        //!< time between two examinations of all stations
+  CandidateQueue m_candidateQueue;                             //!< backlogged stations ordered by weight bound
+  std::vector<uint16_t> m_popped;                              //!< stations examined in the scheduling cycle
+  RuPowerAllocator m_ruPower;                                  //!< power of each RU of the DL MU PPDU
+  StaStateTable m_staTable;                                    //!< scheduler state of each station, indexed by AID
+  OfdmaSchedulerCore m_core;                                   //!< weights, ranking and RU allocation
+  Time m_availableTime;                                        //!< time available for the DL MU PPDU
+  SchedulerArena m_arena;                                      //!< scratch data of the scheduling cycle
 
+  /**
+   * Take the DL scheduling decision for the candidates in m_staTable.
+   */
+  void mlwdf (void);
 };
 
 
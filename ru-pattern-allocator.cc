@@ -0,0 +1,642 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ru-pattern-allocator.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace ns3 {
+
+namespace {
+
+/// Value of the infeasible states of the dynamic program (gains are non-negative)
+const double INFEASIBLE = -1.0;
+/// Number of signature bytes of the channel, time available and maximum number of users
+const std::size_t PLAN_KEY_HEADER = 5;
+/// Number of signature bytes of each candidate
+const std::size_t PLAN_KEY_PER_CANDIDATE = 3;
+
+/**
+ * \param a a value
+ * \param b another value
+ * \return true if the two values are equal up to rounding errors
+ */
+bool
+AlmostEqual (double a, double b)
+{
+  return std::abs (a - b) <= 1e-9 * std::max (std::abs (a), std::abs (b));
+}
+
+/**
+ * \param x a value not lower than 1
+ * \return the index of the half-octave of x, i.e., floor (2 log2 (x)), capped at 254
+ */
+uint8_t
+HalfOctave (double x)
+{
+  int exponent;
+  std::frexp (x * x, &exponent);
+  return static_cast<uint8_t> (std::min (std::max (exponent - 1, 0), 254));
+}
+
+} // unnamed namespace
+
+RuPatternAllocator::RuPatternAllocator ()
+  : m_nCandidates (0),
+    m_queuedBytes (0),
+    m_mcs (0),
+    m_width (0),
+    m_guardInterval (0),
+    m_durationNs (0),
+    m_composition {},
+    m_airtime (0)
+{
+}
+
+void
+RuPatternAllocator::SetPlanCache (std::size_t nEntries, std::size_t maxCandidates)
+{
+  m_planCache.SetCapacity (nEntries, PLAN_KEY_HEADER + PLAN_KEY_PER_CANDIDATE * maxCandidates, maxCandidates);
+}
+
+uint64_t
+RuPatternAllocator::GetPlanCacheHits (void) const
+{
+  return m_planCache.GetHits ();
+}
+
+uint64_t
+RuPatternAllocator::GetPlanCacheMisses (void) const
+{
+  return m_planCache.GetMisses ();
+}
+
+double
+RuPatternAllocator::Allocate (const std::vector<double>& weights, const std::vector<uint8_t>& mcs,
+                              const std::vector<uint32_t>& queuedBytes, const HeRuTiling& tilings,
+                              uint16_t guardInterval, uint64_t durationNs, std::size_t maxUsers)
+{
+  m_assignment.clear ();
+  m_composition.fill (0);
+  m_airtime = 0;
+
+  if (weights.empty ())
+    {
+      return INFEASIBLE;
+    }
+  // at most one RU per candidate: reserve both buffers (they are swapped) so
+  // that an unusually large pattern does not reallocate them mid-run
+  m_assignment.reserve (weights.size ());
+  m_candidateAssignment.reserve (weights.size ());
+
+  m_nCandidates = weights.size ();
+  m_queuedBytes = &queuedBytes;
+  m_mcs = &mcs;
+  m_width = tilings.GetChannelWidth ();
+  m_guardInterval = guardInterval;
+  m_durationNs = durationNs;
+
+  if (m_planCache.IsEnabled ())
+    {
+      BuildPlanKey (weights, maxUsers);
+      const Plan* plan = m_planCache.Find ();
+      if (plan != 0)
+        {
+          return RestorePlan (*plan, weights);
+        }
+    }
+
+  // gain of each candidate for each RU size and, for each RU size, the sum of
+  // the c largest gains over all the candidates, for c = 0, ..., m_nCandidates
+  m_gain.assign (m_nCandidates * HeRateTable::N_RU_SIZES, 0.0);
+  m_bestGains.assign ((m_nCandidates + 1) * HeRateTable::N_RU_SIZES, 0.0);
+  std::vector<double>& gains = m_sortedGains;
+  gains.resize (m_nCandidates);
+
+  for (uint8_t ru = 0; ru < HeRateTable::N_RU_SIZES; ru++)
+    {
+      if (!HeRateTable::IsValid (m_width, ru))
+        {
+          continue;
+        }
+      for (std::size_t i = 0; i < m_nCandidates; i++)
+        {
+          uint32_t bytes = HeRateTable::GetBytesInDuration (durationNs, mcs[i], m_width, guardInterval, ru);
+          m_gain[i * HeRateTable::N_RU_SIZES + ru] = weights[i] * std::min (bytes, queuedBytes[i]);
+          gains[i] = m_gain[i * HeRateTable::N_RU_SIZES + ru];
+        }
+      std::sort (gains.begin (), gains.end (), std::greater<double> ());
+      double* prefix = &m_bestGains[ru * (m_nCandidates + 1)];
+      for (std::size_t c = 0; c < m_nCandidates; c++)
+        {
+          prefix[c + 1] = prefix[c] + gains[c];
+        }
+    }
+
+  // tilings are sorted by number of RUs, hence the eligible ones come first
+  std::size_t nTilings = tilings.GetNTilings (std::min (m_nCandidates, maxUsers));
+  m_bounds.clear ();
+  for (std::size_t t = 0; t < nTilings; t++)
+    {
+      m_bounds.push_back ({GetUpperBound (tilings.GetTiling (t).composition), t});
+    }
+  std::sort (m_bounds.begin (), m_bounds.end (),
+             [] (const std::pair<double, std::size_t>& a, const std::pair<double, std::size_t>& b)
+             { return a.first > b.first || (a.first == b.first && a.second < b.second); });
+
+  m_prices.clear ();
+  m_dualConstant.clear ();
+
+  double bestValue = INFEASIBLE;
+  uint64_t bestDuration = std::numeric_limits<uint64_t>::max ();
+  std::size_t bestTiling = nTilings;
+
+  for (auto& bound : m_bounds)
+    {
+      // no other tiling can even match the best value found so far
+      if (bestValue >= 0 && bound.first < bestValue && !AlmostEqual (bound.first, bestValue))
+        {
+          break;
+        }
+
+      const Composition& composition = tilings.GetTiling (bound.second).composition;
+      if (bestValue >= 0 && GetDualBound (composition) < bestValue
+          && !AlmostEqual (GetDualBound (composition), bestValue))
+        {
+          continue;
+        }
+
+      double value = Assign (composition, m_candidateAssignment);
+      if (value < 0)
+        {
+          continue;
+        }
+      AddDualPrices (m_candidateAssignment);
+
+      bool equal = (bestValue >= 0 && AlmostEqual (value, bestValue));
+      uint64_t duration = GetPpduDuration (m_candidateAssignment);
+      if ((value > bestValue && !equal) || (equal && duration < bestDuration))
+        {
+          bestValue = value;
+          bestDuration = duration;
+          bestTiling = bound.second;
+          m_assignment.swap (m_candidateAssignment);
+        }
+    }
+
+  if (bestTiling == nTilings)
+    {
+      return INFEASIBLE;
+    }
+  m_composition = tilings.GetTiling (bestTiling).composition;
+  m_airtime = bestDuration;
+
+  // place the RUs in the channel, largest first, to get their indices. The
+  // assignment is in candidate order, which is kept among RUs of the same size
+  // (std::stable_sort would allocate a temporary buffer)
+  std::sort (m_assignment.begin (), m_assignment.end (),
+             [] (const Assignment& a, const Assignment& b)
+             { return a.sizeIndex > b.sizeIndex || (a.sizeIndex == b.sizeIndex && a.candidate < b.candidate); });
+  m_sizes.clear ();
+  for (auto& a : m_assignment)
+    {
+      m_sizes.push_back (a.sizeIndex);
+    }
+  HeRuTiling::Mask occupied {{0, 0}};
+  NS_ABORT_MSG_IF (!tilings.Place (m_sizes, occupied, m_rus), "The RUs of a tiling could not be placed");
+  for (std::size_t i = 0; i < m_assignment.size (); i++)
+    {
+      m_assignment[i].ru = m_rus[i];
+    }
+
+  if (m_planCache.IsEnabled ())
+    {
+      Plan& plan = m_planCache.Insert ();
+      plan.composition = m_composition;
+      plan.assignment = m_assignment;
+    }
+  return bestValue;
+}
+
+void
+RuPatternAllocator::BuildPlanKey (const std::vector<double>& weights, std::size_t maxUsers)
+{
+  m_planCache.ClearKey ();
+  m_planCache.AddToKey (static_cast<uint8_t> (m_width / 5));
+  m_planCache.AddToKey (static_cast<uint8_t> (m_guardInterval / 100));
+  // steps of 65.536 us
+  m_planCache.AddToKey (static_cast<uint8_t> (std::min<uint64_t> (m_durationNs >> 16, 255)));
+  m_planCache.AddToKey (static_cast<uint8_t> (std::min<std::size_t> (maxUsers, 255)));
+  m_planCache.AddToKey (static_cast<uint8_t> (std::min<std::size_t> (m_nCandidates, 255)));
+
+  double maxWeight = *std::max_element (weights.begin (), weights.end ());
+  for (std::size_t i = 0; i < m_nCandidates; i++)
+    {
+      m_planCache.AddToKey ((*m_mcs)[i]);
+      m_planCache.AddToKey (HalfOctave (1.0 + (*m_queuedBytes)[i]));
+      // candidates with a null weight are never worth serving
+      m_planCache.AddToKey (weights[i] > 0 ? HalfOctave (maxWeight / weights[i]) : 255);
+    }
+}
+
+double
+RuPatternAllocator::RestorePlan (const Plan& plan, const std::vector<double>& weights)
+{
+  m_composition = plan.composition;
+  m_assignment = plan.assignment;
+  m_airtime = GetPpduDuration (m_assignment);
+
+  double value = 0.0;
+  for (auto& a : m_assignment)
+    {
+      uint32_t bytes = HeRateTable::GetBytesInDuration (m_durationNs, (*m_mcs)[a.candidate], m_width,
+                                                        m_guardInterval, a.sizeIndex);
+      value += weights[a.candidate] * std::min (bytes, (*m_queuedBytes)[a.candidate]);
+    }
+  return value;
+}
+
+const std::vector<RuPatternAllocator::Assignment>&
+RuPatternAllocator::GetAssignment (void) const
+{
+  return m_assignment;
+}
+
+const HeRuTiling::Composition&
+RuPatternAllocator::GetComposition (void) const
+{
+  return m_composition;
+}
+
+uint64_t
+RuPatternAllocator::GetAirtime (void) const
+{
+  return m_airtime;
+}
+
+double
+RuPatternAllocator::GetUpperBound (const Composition& composition) const
+{
+  double bound = 0.0;
+  for (uint8_t ru = 0; ru < HeRateTable::N_RU_SIZES; ru++)
+    {
+      std::size_t count = std::min<std::size_t> (composition[ru], m_nCandidates);
+      bound += m_bestGains[ru * (m_nCandidates + 1) + count];
+    }
+  return bound;
+}
+
+double
+RuPatternAllocator::GetDualBound (const Composition& composition) const
+{
+  double bound = std::numeric_limits<double>::max ();
+  for (std::size_t k = 0; k < m_dualConstant.size (); k++)
+    {
+      double value = m_dualConstant[k];
+      for (uint8_t ru = 0; ru < HeRateTable::N_RU_SIZES; ru++)
+        {
+          value += composition[ru] * m_prices[k * HeRateTable::N_RU_SIZES + ru];
+        }
+      bound = std::min (bound, value);
+    }
+  return bound;
+}
+
+void
+RuPatternAllocator::AddDualPrices (const std::vector<Assignment>& assignment)
+{
+  // Find the smallest prices satisfying the complementary slackness conditions
+  // with the given (optimal) assignment: the price of an RU size must be at
+  // least the gain of every unserved candidate with that RU size and, for every
+  // served candidate, at least the price of the RU size it is assigned plus the
+  // gain difference between the two RU sizes. Since prices only appear in the
+  // constraints as differences, this is a longest path problem over RU sizes.
+  static const uint8_t N = HeRateTable::N_RU_SIZES;
+  double prices[N];
+  double lowest = 0.0;
+  std::fill (prices, prices + N, lowest);
+
+  m_served.assign (m_nCandidates, N);
+  for (auto& a : assignment)
+    {
+      m_served[a.candidate] = a.sizeIndex;
+    }
+  for (std::size_t i = 0; i < m_nCandidates; i++)
+    {
+      if (m_served[i] == N)
+        {
+          for (uint8_t ru = 0; ru < N; ru++)
+            {
+              prices[ru] = std::max (prices[ru], m_gain[i * N + ru]);
+            }
+        }
+    }
+  // Bellman-Ford over the RU sizes (the residual graph has no positive cycles
+  // if the assignment is optimal, but bound the iterations anyway)
+  for (uint8_t iter = 0; iter < N; iter++)
+    {
+      bool updated = false;
+      for (auto& a : assignment)
+        {
+          const double* gain = &m_gain[a.candidate * N];
+          for (uint8_t ru = 0; ru < N; ru++)
+            {
+              double price = prices[a.sizeIndex] + gain[ru] - gain[a.sizeIndex];
+              if (price > prices[ru] && !AlmostEqual (price, prices[ru]))
+                {
+                  prices[ru] = price;
+                  updated = true;
+                }
+            }
+        }
+      if (!updated)
+        {
+          break;
+        }
+    }
+
+  // by weak duality, for every composition c, the value of the best assignment
+  // is at most sum_i max (0, max_ru (gain[i][ru] - price[ru])) + sum_ru c[ru] price[ru]
+  double constant = 0.0;
+  for (std::size_t i = 0; i < m_nCandidates; i++)
+    {
+      double utility = 0.0;
+      for (uint8_t ru = 0; ru < N; ru++)
+        {
+          utility = std::max (utility, m_gain[i * N + ru] - prices[ru]);
+        }
+      constant += utility;
+    }
+  m_dualConstant.push_back (constant);
+  m_prices.insert (m_prices.end (), prices, prices + N);
+}
+
+double
+RuPatternAllocator::Assign (const Composition& composition, std::vector<Assignment>& assignment)
+{
+  // Successive shortest augmenting paths: at every step, one more RU is assigned
+  // along the path of largest gain, which starts from an unserved candidate,
+  // possibly moves some served candidates to an RU of another size and ends at
+  // an RU size with RUs left. After every step the assignment is optimal for the
+  // number of RUs assigned so far. Since there are only N_RU_SIZES RU sizes,
+  // paths are computed by Bellman-Ford over the RU sizes.
+  static const uint8_t N = HeRateTable::N_RU_SIZES;
+  const double NONE = -std::numeric_limits<double>::max ();
+
+  uint8_t left[N];
+  std::size_t nRus = 0;
+  for (uint8_t ru = 0; ru < N; ru++)
+    {
+      left[ru] = composition[ru];
+      nRus += composition[ru];
+    }
+
+  assignment.clear ();
+  m_served.assign (m_nCandidates, N);
+
+  double entry[N];                // best gain of an unserved candidate for each RU size
+  std::size_t entryCandidate[N];
+  double move[N][N];              // best gain of moving a served candidate between RU sizes
+  std::size_t moveCandidate[N][N];
+  double dist[N];                 // gain of the best path ending at each RU size
+  uint8_t pred[N];                // RU size preceding each RU size in the path (N if none)
+
+  for (std::size_t k = 0; k < nRus; k++)
+    {
+      std::fill (entry, entry + N, NONE);
+      std::fill (&move[0][0], &move[0][0] + N * N, NONE);
+
+      for (std::size_t i = 0; i < m_nCandidates; i++)
+        {
+          const double* gain = &m_gain[i * N];
+          uint8_t from = m_served[i];
+          for (uint8_t to = 0; to < N; to++)
+            {
+              if (composition[to] == 0 || to == from)
+                {
+                  continue;
+                }
+              if (from == N && gain[to] > entry[to])
+                {
+                  entry[to] = gain[to];
+                  entryCandidate[to] = i;
+                }
+              else if (from < N && gain[to] - gain[from] > move[from][to])
+                {
+                  move[from][to] = gain[to] - gain[from];
+                  moveCandidate[from][to] = i;
+                }
+            }
+        }
+
+      std::copy (entry, entry + N, dist);
+      std::fill (pred, pred + N, N);
+      for (uint8_t iter = 0; iter < N; iter++)
+        {
+          bool updated = false;
+          for (uint8_t from = 0; from < N; from++)
+            {
+              for (uint8_t to = 0; to < N; to++)
+                {
+                  if (dist[from] == NONE || move[from][to] == NONE)
+                    {
+                      continue;
+                    }
+                  double d = dist[from] + move[from][to];
+                  if (d > dist[to] && !AlmostEqual (d, dist[to]))
+                    {
+                      dist[to] = d;
+                      pred[to] = from;
+                      updated = true;
+                    }
+                }
+            }
+          if (!updated)
+            {
+              break;
+            }
+        }
+
+      // in case of ties, prefer to assign larger RUs first (i.e., to the
+      // candidates with the largest weight, which come first)
+      uint8_t end = N;
+      for (uint8_t ru = N; ru-- > 0; )
+        {
+          if (left[ru] > 0 && dist[ru] != NONE && (end == N || dist[ru] > dist[end]))
+            {
+              end = ru;
+            }
+        }
+      if (end == N)
+        {
+          return INFEASIBLE;
+        }
+
+      // apply the moves along the path, then serve the entering candidate
+      uint8_t ru = end;
+      for (uint8_t hops = 0; pred[ru] != N && hops < N; hops++)
+        {
+          m_served[moveCandidate[pred[ru]][ru]] = ru;
+          ru = pred[ru];
+        }
+      m_served[entryCandidate[ru]] = ru;
+      left[end]--;
+    }
+
+  double value = 0.0;
+  for (std::size_t i = 0; i < m_nCandidates; i++)
+    {
+      if (m_served[i] < N)
+        {
+          assignment.push_back ({i, m_served[i], HeRu::RuSpec ()});
+          value += m_gain[i * N + m_served[i]];
+        }
+    }
+  return value;
+}
+
+bool
+RuPatternAllocator::PlaceBySnr (const std::vector<double>& weights, const std::vector<float>& snrDb,
+                                std::size_t stride, const HeRuTiling& tilings)
+{
+  NS_ASSERT (weights.size () == m_nCandidates && snrDb.size () >= m_nCandidates * stride);
+  const double UNKNOWN = -std::numeric_limits<double>::max ();
+
+  HeRuTiling::Mask occupied {{0, 0}};
+  m_rus.assign (m_assignment.size (), HeRu::RuSpec ());
+  m_placed.assign (m_assignment.size (), 0);
+
+  // the assignment is sorted by decreasing RU size: place the RUs of each size in turn
+  for (std::size_t first = 0, last = 0; first < m_assignment.size (); first = last)
+    {
+      uint8_t size = m_assignment[first].sizeIndex;
+      last = first;
+      while (last < m_assignment.size () && m_assignment[last].sizeIndex == size)
+        {
+          last++;
+        }
+      std::size_t nRus = tilings.GetNRus (size);
+
+      m_placeValue.assign ((last - first) * nRus, 0.0);
+      m_placeSnr.assign ((last - first) * nRus, UNKNOWN);
+      for (std::size_t a = first; a < last; a++)
+        {
+          std::size_t i = m_assignment[a].candidate;
+          const float* snr = &snrDb[i * stride];
+          for (std::size_t r = 0; r < nRus; r++)
+            {
+              const HeRuTiling::Mask& mask = tilings.GetMask (size, r);
+              if (HeRuTiling::Overlap (occupied, mask))
+                {
+                  continue;
+                }
+              double sum = 0.0;
+              std::size_t count = 0;
+              for (std::size_t w = 0; w < mask.size (); w++)
+                {
+                  for (uint64_t word = mask[w]; word != 0; word &= word - 1)
+                    {
+                      std::size_t p = w * 64 + __builtin_ctzll (word);
+                      if (p < stride && !std::isnan (snr[p]))
+                        {
+                          sum += snr[p];
+                          count++;
+                        }
+                    }
+                }
+              uint8_t mcs = (*m_mcs)[i];
+              std::size_t k = (a - first) * nRus + r;
+              if (count > 0)
+                {
+                  m_placeSnr[k] = sum / count;
+                  mcs = HeRateTable::GetMaxMcs (m_placeSnr[k], mcs);
+                }
+              uint32_t bytes = HeRateTable::GetBytesInDuration (m_durationNs, mcs, m_width, m_guardInterval, size);
+              m_placeValue[k] = weights[i] * std::min (bytes, (*m_queuedBytes)[i]);
+            }
+        }
+
+      // greedy matching of the RUs of this size to the free RUs of the channel
+      for (std::size_t n = first; n < last; n++)
+        {
+          std::size_t bestA = last, bestR = nRus;
+          for (std::size_t a = first; a < last; a++)
+            {
+              if (m_placed[a] != 0)
+                {
+                  continue;
+                }
+              for (std::size_t r = 0; r < nRus; r++)
+                {
+                  std::size_t k = (a - first) * nRus + r;
+                  if (HeRuTiling::Overlap (occupied, tilings.GetMask (size, r)))
+                    {
+                      continue;
+                    }
+                  if (bestA == last)
+                    {
+                      bestA = a;
+                      bestR = r;
+                      continue;
+                    }
+                  std::size_t best = (bestA - first) * nRus + bestR;
+                  if (m_placeValue[k] > m_placeValue[best]
+                      || (m_placeValue[k] == m_placeValue[best] && m_placeSnr[k] > m_placeSnr[best]))
+                    {
+                      bestA = a;
+                      bestR = r;
+                    }
+                }
+            }
+          if (bestA == last)
+            {
+              return false;
+            }
+          const HeRuTiling::Mask& mask = tilings.GetMask (size, bestR);
+          occupied[0] |= mask[0];
+          occupied[1] |= mask[1];
+          m_rus[bestA] = tilings.GetRu (size, bestR);
+          m_placed[bestA] = 1;
+        }
+    }
+
+  for (std::size_t a = 0; a < m_assignment.size (); a++)
+    {
+      m_assignment[a].ru = m_rus[a];
+    }
+  return true;
+}
+
+uint64_t
+RuPatternAllocator::GetPpduDuration (const std::vector<Assignment>& assignment) const
+{
+  uint64_t duration = 0;
+  for (auto& a : assignment)
+    {
+      uint8_t ru = a.sizeIndex;
+      uint8_t mcs = (*m_mcs)[a.candidate];
+      uint32_t bytes = std::min ((*m_queuedBytes)[a.candidate],
+                                 HeRateTable::GetBytesInDuration (m_durationNs, mcs, m_width, m_guardInterval, ru));
+      duration = std::max (duration, HeRateTable::GetAirtimeNs (bytes, mcs, m_width, m_guardInterval, ru));
+    }
+  return duration;
+}
+
+} //namespace ns3
@@ -0,0 +1,235 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RU_PATTERN_ALLOCATOR_H
+#define RU_PATTERN_ALLOCATOR_H
+
+#include "he-ru-tiling.h"
+#include "ru-plan-cache.h"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * RuPatternAllocator selects, among the tilings of the channel (see
+ * HeRuTiling), the tiling and the assignment of its RUs to the candidate
+ * stations that maximize the sum over the served stations of the M-LWDF weight
+ * times the amount of bytes the station can receive within the given duration
+ * (capped by the amount of bytes queued for the station).
+ *
+ * Tilings are explored best-first by branch and bound. The upper bound of a
+ * tiling is the sum, over its RU sizes, of the largest gains achievable with
+ * RUs of that size, taken over all the candidates. The optimal assignment for a
+ * tiling is a transportation problem with only N_RU_SIZES destinations, solved
+ * by successive shortest augmenting paths over the RU sizes. The prices of the
+ * RU sizes in the optimal assignment (the dual solution) yield a tighter bound
+ * for the tilings still to explore. The search stops as soon as the bound of
+ * the next tiling is below the best value found. Among tilings with the same
+ * value, the one requiring the shortest PPDU is preferred, so as to reduce
+ * padding.
+ *
+ * If the plan cache is enabled, the selected tiling and placed RUs are
+ * memoized by a signature made of the channel, the time available, the
+ * maximum number of users and, for each candidate, its MCS, the half-octave
+ * of its queued bytes and the half-octave of the ratio of the largest weight
+ * to its weight. An allocation whose signature is found reuses the memoized
+ * plan, skipping the search and the placement of the RUs; only its value and
+ * PPDU duration are computed from the actual inputs.
+ */
+class RuPatternAllocator
+{
+public:
+  /// The RU assigned to a candidate station
+  struct Assignment
+  {
+    std::size_t candidate;  //!< the index of the candidate station
+    uint8_t sizeIndex;      //!< the index of the size of the assigned RU in HeRateTable
+    HeRu::RuSpec ru;        //!< the assigned RU
+  };
+
+  RuPatternAllocator ();
+
+  /**
+   * Enable or disable the plan cache, discarding the memoized plans.
+   *
+   * \param nEntries the number of plans the cache can hold (0 disables the cache)
+   * \param maxCandidates the largest number of candidates of an allocation
+   */
+  void SetPlanCache (std::size_t nEntries, std::size_t maxCandidates);
+  /**
+   * \return the number of allocations that reused a memoized plan
+   */
+  uint64_t GetPlanCacheHits (void) const;
+  /**
+   * \return the number of allocations that searched for a plan while the
+   *         plan cache was enabled
+   */
+  uint64_t GetPlanCacheMisses (void) const;
+
+  /**
+   * Select the tiling and the assignment of RUs to candidate stations.
+   *
+   * \param weights the M-LWDF weight of each candidate
+   * \param mcs the HE MCS used to transmit to each candidate
+   * \param queuedBytes the bytes queued for each candidate
+   * \param tilings the tilings of the channel
+   * \param guardInterval the guard interval in nanoseconds
+   * \param durationNs the time available to transmit the Data field of the PPDU
+   * \param maxUsers the maximum number of stations that can be served
+   * \return the value (sum of weighted bytes) of the selected allocation, or a
+   *         negative value if no tiling can be used
+   */
+  double Allocate (const std::vector<double>& weights, const std::vector<uint8_t>& mcs,
+                   const std::vector<uint32_t>& queuedBytes, const HeRuTiling& tilings,
+                   uint16_t guardInterval, uint64_t durationNs, std::size_t maxUsers);
+  /**
+   * Move the RUs of the assignment computed by the last call to Allocate (whose
+   * inputs must still be valid) to the positions where the candidates get the
+   * most out of their SNR. The RU sizes are unchanged. The RUs are placed
+   * largest first and, for each RU size, the candidates are matched greedily
+   * to the free RUs of that size by the weighted bytes they can receive at the
+   * MCS their SNR on the RU supports (not above their MCS), ties broken by the
+   * highest SNR. The SNR on an RU is the mean of the known SNRs on the 26-tone
+   * RU positions it covers; a candidate whose SNR is unknown on an RU is
+   * deemed to support its MCS there. If the RUs cannot be placed this way, the
+   * assignment is left unchanged.
+   *
+   * \param weights the weight of each candidate
+   * \param snrDb the SNR (dB) of each candidate on each 26-tone RU position
+   *        of the channel (NaN if unknown), stride values per candidate
+   * \param stride the number of values per candidate
+   * \param tilings the tilings of the channel
+   * \return true if the RUs have been moved
+   */
+  bool PlaceBySnr (const std::vector<double>& weights, const std::vector<float>& snrDb,
+                   std::size_t stride, const HeRuTiling& tilings);
+  /**
+   * \return the assignment computed by the last call to Allocate, sorted by
+   *         decreasing RU size
+   */
+  const std::vector<Assignment>& GetAssignment (void) const;
+  /**
+   * \return the number of RUs of each size of the tiling selected by the last
+   *         call to Allocate
+   */
+  const HeRuTiling::Composition& GetComposition (void) const;
+  /**
+   * \return the duration (ns) of the Data field of the PPDU required by the
+   *         assignment computed by the last call to Allocate
+   */
+  uint64_t GetAirtime (void) const;
+
+private:
+  typedef HeRuTiling::Composition Composition;  //!< number of RUs of each size
+
+  /// An allocation memoized by the plan cache
+  struct Plan
+  {
+    Composition composition;              //!< the selected tiling
+    std::vector<Assignment> assignment;   //!< the assignment, with the placed RUs
+
+    /**
+     * \param nUsers the number of RUs to reserve memory for
+     */
+    void Reserve (std::size_t nUsers)
+    {
+      assignment.reserve (nUsers);
+    }
+  };
+
+  /**
+   * Build the signature of the current call to Allocate in the plan cache.
+   *
+   * \param weights the weight of each candidate
+   * \param maxUsers the maximum number of stations that can be served
+   */
+  void BuildPlanKey (const std::vector<double>& weights, std::size_t maxUsers);
+  /**
+   * Make the given memoized plan the result of the current call to Allocate.
+   *
+   * \param plan the memoized plan
+   * \param weights the weight of each candidate
+   * \return the value of the plan for the current inputs
+   */
+  double RestorePlan (const Plan& plan, const std::vector<double>& weights);
+
+  /**
+   * \param composition the number of RUs of each size of a tiling
+   * \return an upper bound to the value achievable with the tiling
+   */
+  double GetUpperBound (const Composition& composition) const;
+  /**
+   * \param composition the number of RUs of each size of a tiling
+   * \return the tightest upper bound to the value achievable with the tiling
+   *         given by the RU prices computed so far
+   */
+  double GetDualBound (const Composition& composition) const;
+  /**
+   * Compute the prices of the RU sizes (dual variables of the assignment
+   * problem) associated with the given optimal assignment and store them to
+   * bound the value of the tilings still to explore.
+   *
+   * \param assignment an optimal assignment for a tiling
+   */
+  void AddDualPrices (const std::vector<Assignment>& assignment);
+  /**
+   * Compute the optimal assignment of the RUs of the given tiling to the
+   * candidate stations.
+   *
+   * \param composition the number of RUs of each size of a tiling
+   * \param assignment the computed assignment
+   * \return the value of the computed assignment
+   */
+  double Assign (const Composition& composition, std::vector<Assignment>& assignment);
+  /**
+   * \param assignment an assignment of RUs to candidates
+   * \return the duration (ns) of the longest Data field among the assigned candidates
+   */
+  uint64_t GetPpduDuration (const std::vector<Assignment>& assignment) const;
+
+  // inputs and scratch data of the current call to Allocate
+  std::size_t m_nCandidates;                    //!< the number of candidate stations
+  const std::vector<uint32_t>* m_queuedBytes;   //!< bytes queued for each candidate
+  const std::vector<uint8_t>* m_mcs;            //!< MCS of each candidate
+  uint16_t m_width;                             //!< the channel width
+  uint16_t m_guardInterval;                     //!< the guard interval
+  uint64_t m_durationNs;                        //!< the time available for the Data field
+  std::vector<double> m_gain;                   //!< gain of each (candidate, RU size) pair
+  std::vector<double> m_bestGains;              //!< prefix sums of the best gains of each RU size
+  std::vector<double> m_sortedGains;            //!< gains of all the candidates for an RU size, sorted
+  std::vector<std::pair<double, std::size_t>> m_bounds; //!< upper bound and index of the eligible tilings
+  std::vector<double> m_prices;                 //!< sets of RU size prices
+  std::vector<double> m_dualConstant;           //!< candidate utility term of each set of prices
+  std::vector<uint8_t> m_served;                //!< RU size assigned to each candidate (N_RU_SIZES if none)
+  std::vector<uint8_t> m_sizes;                 //!< sizes of the RUs to place
+  std::vector<HeRu::RuSpec> m_rus;              //!< the placed RUs
+  std::vector<uint8_t> m_placed;                //!< whether each RU of the assignment is placed
+  std::vector<double> m_placeValue;             //!< weighted bytes of each (RU, channel RU) pair
+  std::vector<double> m_placeSnr;               //!< SNR of each (RU, channel RU) pair
+  std::vector<Assignment> m_candidateAssignment; //!< the assignment for the tiling being explored
+  std::vector<Assignment> m_assignment;         //!< the best assignment found
+  Composition m_composition;                    //!< the tiling of the best assignment
+  uint64_t m_airtime;                           //!< the Data field duration of the best assignment
+  RuPlanCache<Plan> m_planCache;                //!< the memoized allocations
+};
+
+} //namespace ns3
+
+#endif /* RU_PATTERN_ALLOCATOR_H */
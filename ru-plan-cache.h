@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RU_PLAN_CACHE_H
+#define RU_PLAN_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * RuPlanCache memoizes RU allocation plans by a signature of the inputs of
+ * the allocation, i.e., a short sequence of bytes built with AddToKey, which
+ * are quantized values of the inputs so that repeated traffic patterns map to
+ * the same signature. The cache is direct-mapped: the 64-bit FNV-1a hash of
+ * the signature selects an entry, whose signature is compared to the one
+ * looked up, and a plan overwrites the one stored in its entry. The memory is
+ * allocated when the capacity is set, so that storing plans does not allocate
+ * once the entries have reached the reserved size.
+ *
+ * \tparam Plan the type of the memoized plans, which provides
+ *         void Reserve (std::size_t nUsers)
+ */
+template <class Plan>
+class RuPlanCache
+{
+public:
+  RuPlanCache ()
+    : m_hash (FNV_OFFSET),
+      m_hits (0),
+      m_misses (0)
+  {
+  }
+
+  /**
+   * Discard the stored plans and allocate the entries.
+   *
+   * \param nEntries the number of entries (0 disables the cache)
+   * \param keyLength the largest length of a signature
+   * \param nUsers the largest number of users of a plan
+   */
+  void SetCapacity (std::size_t nEntries, std::size_t keyLength, std::size_t nUsers)
+  {
+    m_entries.assign (nEntries, Entry ());
+    for (auto& entry : m_entries)
+      {
+        entry.key.reserve (keyLength);
+        entry.plan.Reserve (nUsers);
+      }
+    m_key.reserve (keyLength);
+    m_hits = 0;
+    m_misses = 0;
+  }
+  /**
+   * \return true if the capacity of the cache is not null
+   */
+  bool IsEnabled (void) const
+  {
+    return !m_entries.empty ();
+  }
+
+  /**
+   * Start building a new signature.
+   */
+  void ClearKey (void)
+  {
+    m_key.clear ();
+    m_hash = FNV_OFFSET;
+  }
+  /**
+   * Append a byte to the signature being built.
+   *
+   * \param value the byte
+   */
+  void AddToKey (uint8_t value)
+  {
+    m_key.push_back (value);
+    m_hash = (m_hash ^ value) * FNV_PRIME;
+  }
+
+  /**
+   * \return the plan stored for the signature built so far, or a null pointer
+   */
+  const Plan* Find (void)
+  {
+    const Entry& entry = m_entries[m_hash % m_entries.size ()];
+    if (entry.valid && entry.hash == m_hash && entry.key == m_key)
+      {
+        m_hits++;
+        return &entry.plan;
+      }
+    m_misses++;
+    return 0;
+  }
+  /**
+   * Store a plan for the signature built so far, in place of the plan stored
+   * in its entry.
+   *
+   * \return the plan to fill
+   */
+  Plan& Insert (void)
+  {
+    Entry& entry = m_entries[m_hash % m_entries.size ()];
+    entry.valid = true;
+    entry.hash = m_hash;
+    entry.key = m_key;
+    return entry.plan;
+  }
+
+  /**
+   * \return the number of lookups that found a plan
+   */
+  uint64_t GetHits (void) const
+  {
+    return m_hits;
+  }
+  /**
+   * \return the number of lookups that found no plan
+   */
+  uint64_t GetMisses (void) const
+  {
+    return m_misses;
+  }
+
+private:
+  static const uint64_t FNV_OFFSET = 14695981039346656037ULL; //!< FNV-1a offset basis
+  static const uint64_t FNV_PRIME = 1099511628211ULL;         //!< FNV-1a prime
+
+  /// An entry of the cache
+  struct Entry
+  {
+    Entry ()
+      : valid (false),
+        hash (0)
+    {
+    }
+
+    bool valid;                 //!< whether a plan is stored
+    uint64_t hash;              //!< the hash of the signature
+    std::vector<uint8_t> key;   //!< the signature
+    Plan plan;                  //!< the plan
+  };
+
+  std::vector<Entry> m_entries;   //!< the entries
+  std::vector<uint8_t> m_key;     //!< the signature being built
+  uint64_t m_hash;                //!< the hash of the signature being built
+  uint64_t m_hits;                //!< the number of lookups that found a plan
+  uint64_t m_misses;              //!< the number of lookups that found no plan
+};
+
+} //namespace ns3
+
+#endif /* RU_PLAN_CACHE_H */
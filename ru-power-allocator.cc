@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "ru-power-allocator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+namespace {
+
+/// Number of bisection steps to find the water level
+const int g_bisectionSteps = 60;
+
+} // unnamed namespace
+
+RuPowerAllocator::RuPowerAllocator ()
+  : m_minPower (1),
+    m_maxPower (1)
+{
+}
+
+void
+RuPowerAllocator::Clear (void)
+{
+  m_aid.clear ();
+  m_tones.clear ();
+  m_weight.clear ();
+  m_gain.clear ();
+  m_power.clear ();
+}
+
+void
+RuPowerAllocator::AddUser (uint16_t aid, uint16_t tones, double weight, double snrDb)
+{
+  m_aid.push_back (aid);
+  m_tones.push_back (tones);
+  m_weight.push_back (weight);
+  m_gain.push_back (std::isnan (snrDb) ? 0.0 : std::pow (10.0, snrDb / 10));
+  m_power.push_back (1.0);
+}
+
+double
+RuPowerAllocator::GetPower (double level) const
+{
+  double total = 0.0;
+  for (std::size_t u = 0; u < m_aid.size (); u++)
+    {
+      if (m_gain[u] > 0)
+        {
+          total += m_tones[u] * std::min (std::max (m_weight[u] * level - 1 / m_gain[u], m_minPower), m_maxPower);
+        }
+    }
+  return total;
+}
+
+void
+RuPowerAllocator::Allocate (double maxOffsetDb)
+{
+  NS_ASSERT (maxOffsetDb >= 0);
+  m_minPower = std::pow (10.0, -maxOffsetDb / 10);
+  m_maxPower = std::pow (10.0, maxOffsetDb / 10);
+
+  // the budget is the power of the users whose SNR is known at the uniform PSD;
+  // weights are normalized to their mean, so that the water level is about 1
+  double budget = 0.0, sumWeights = 0.0;
+  std::size_t nKnown = 0;
+  for (std::size_t u = 0; u < m_aid.size (); u++)
+    {
+      m_power[u] = 1.0;
+      if (m_gain[u] > 0)
+        {
+          budget += m_tones[u];
+          sumWeights += m_weight[u];
+          nKnown++;
+        }
+    }
+  if (nKnown < 2)
+    {
+      return;
+    }
+  for (std::size_t u = 0; u < m_aid.size (); u++)
+    {
+      m_weight[u] = (sumWeights > 0 ? m_weight[u] * nKnown / sumWeights : 1.0);
+      if (m_weight[u] <= 0)
+        {
+          // users with a null weight are only given the smallest power
+          m_weight[u] = 0;
+        }
+    }
+
+  // the total power grows with the water level: all the users get the
+  // smallest power at level 0 and the largest power at a high enough level
+  double low = 0.0, high = 1.0;
+  while (GetPower (high) < budget && high < 1e12)
+    {
+      high *= 2;
+    }
+  for (int step = 0; step < g_bisectionSteps; step++)
+    {
+      double level = (low + high) / 2;
+      (GetPower (level) < budget ? low : high) = level;
+    }
+
+  for (std::size_t u = 0; u < m_aid.size (); u++)
+    {
+      if (m_gain[u] > 0)
+        {
+          m_power[u] = std::min (std::max (m_weight[u] * low - 1 / m_gain[u], m_minPower), m_maxPower);
+        }
+    }
+}
+
+double
+RuPowerAllocator::GetOffsetDb (uint16_t aid) const
+{
+  for (std::size_t u = 0; u < m_aid.size (); u++)
+    {
+      if (m_aid[u] == aid)
+        {
+          return 10 * std::log10 (m_power[u]);
+        }
+    }
+  return 0.0;
+}
+
+} //namespace ns3
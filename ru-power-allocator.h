@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RU_POWER_ALLOCATOR_H
+#define RU_POWER_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * RuPowerAllocator spreads the transmit power of a DL MU PPDU across its RUs.
+ * The power per tone of each RU is expressed relative to a uniform power
+ * spectral density (offset 0 dB), so that the total power is the same as
+ * with a uniform PSD when the offsets of all the tones average to 0 dB. The
+ * power per tone p_u of the RU of user u maximizes the sum of
+ * w_u n_u log2 (1 + g_u p_u), where n_u is the number of tones of the RU, w_u
+ * the scheduling weight of the user and g_u its SNR at the uniform PSD,
+ * subject to the total power and to a PSD limit: by weighted water-filling,
+ * p_u = w_u mu - 1 / g_u, clamped to the allowed range of offsets, where the
+ * water level mu is found by bisection. Users whose SNR is unknown keep the
+ * uniform PSD.
+ */
+class RuPowerAllocator
+{
+public:
+  RuPowerAllocator ();
+
+  /**
+   * Remove all the users.
+   */
+  void Clear (void);
+  /**
+   * Add a user granted an RU.
+   *
+   * \param aid the AID of the user
+   * \param tones the number of tones of the RU
+   * \param weight the scheduling weight of the user
+   * \param snrDb the SNR (dB) of the user on the RU at the uniform PSD, NaN if unknown
+   */
+  void AddUser (uint16_t aid, uint16_t tones, double weight, double snrDb);
+  /**
+   * Compute the power of each RU.
+   *
+   * \param maxOffsetDb the largest offset (dB) of the power per tone from the
+   *        uniform PSD, in either direction (PSD limit)
+   */
+  void Allocate (double maxOffsetDb);
+  /**
+   * \param aid the AID of a user
+   * \return the offset (dB) of the power per tone of the RU of the user from
+   *         the uniform PSD computed by the last call to Allocate (0 if the
+   *         user was not added)
+   */
+  double GetOffsetDb (uint16_t aid) const;
+
+private:
+  /**
+   * \param level the water level
+   * \return the total power (tones times power per tone) of the users whose SNR is known
+   */
+  double GetPower (double level) const;
+
+  std::vector<uint16_t> m_aid;       //!< AID of each user
+  std::vector<double> m_tones;       //!< tones of the RU of each user
+  std::vector<double> m_weight;      //!< weight of each user
+  std::vector<double> m_gain;        //!< SNR (linear) of each user at the uniform PSD, 0 if unknown
+  std::vector<double> m_power;       //!< power per tone of each user, relative to the uniform PSD
+  double m_minPower;                 //!< the smallest power per tone
+  double m_maxPower;                 //!< the largest power per tone
+};
+
+} //namespace ns3
+
+#endif /* RU_POWER_ALLOCATOR_H */
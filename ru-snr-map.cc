@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "ru-snr-map.h"
+#include <algorithm>
+#include <limits>
+
+namespace ns3 {
+
+RuSnrMap::RuSnrMap ()
+  : m_alpha (0.25),
+    m_maxAge (100000000)
+{
+}
+
+void
+RuSnrMap::SetAveraging (double alpha)
+{
+  NS_ASSERT (alpha > 0 && alpha <= 1);
+  m_alpha = alpha;
+}
+
+void
+RuSnrMap::SetMaxAge (int64_t maxAge)
+{
+  m_maxAge = maxAge;
+}
+
+void
+RuSnrMap::Grow (uint16_t aid)
+{
+  std::size_t size = (static_cast<std::size_t> (aid) + 1) * MAX_POSITIONS;
+  if (size > m_snr.size ())
+    {
+      m_snr.resize (size, 0);
+      m_updated.resize (size, -1);
+    }
+}
+
+void
+RuSnrMap::NotifyAssociation (uint16_t aid)
+{
+  Grow (aid);
+  std::fill_n (m_updated.begin () + aid * MAX_POSITIONS, MAX_POSITIONS, -1);
+}
+
+void
+RuSnrMap::NotifyDisassociation (uint16_t aid)
+{
+  if (aid * MAX_POSITIONS < m_updated.size ())
+    {
+      std::fill_n (m_updated.begin () + aid * MAX_POSITIONS, MAX_POSITIONS, -1);
+    }
+}
+
+void
+RuSnrMap::NotifySnr (uint16_t aid, const HeRuTiling::Mask& positions, double snrDb, int64_t now)
+{
+  Grow (aid);
+  float* snr = &m_snr[aid * MAX_POSITIONS];
+  int64_t* updated = &m_updated[aid * MAX_POSITIONS];
+
+  for (std::size_t w = 0; w < positions.size (); w++)
+    {
+      for (uint64_t word = positions[w]; word != 0; word &= word - 1)
+        {
+          std::size_t p = w * 64 + __builtin_ctzll (word);
+          NS_ASSERT (p < MAX_POSITIONS);
+          bool fresh = (updated[p] >= 0 && now - updated[p] <= m_maxAge);
+          snr[p] = static_cast<float> (fresh ? (1 - m_alpha) * snr[p] + m_alpha * snrDb : snrDb);
+          updated[p] = now;
+        }
+    }
+}
+
+bool
+RuSnrMap::GetSnr (uint16_t aid, int64_t now, float* snrDb) const
+{
+  std::fill_n (snrDb, MAX_POSITIONS, std::numeric_limits<float>::quiet_NaN ());
+  if (aid * MAX_POSITIONS >= m_snr.size ())
+    {
+      return false;
+    }
+
+  const float* snr = &m_snr[aid * MAX_POSITIONS];
+  const int64_t* updated = &m_updated[aid * MAX_POSITIONS];
+  bool known = false;
+  for (std::size_t p = 0; p < MAX_POSITIONS; p++)
+    {
+      if (updated[p] >= 0 && now - updated[p] <= m_maxAge)
+        {
+          snrDb[p] = snr[p];
+          known = true;
+        }
+    }
+  return known;
+}
+
+bool
+RuSnrMap::GetRuSnr (uint16_t aid, const HeRuTiling::Mask& ru, int64_t now, double& snrDb) const
+{
+  if (aid * MAX_POSITIONS >= m_snr.size ())
+    {
+      return false;
+    }
+
+  const float* snr = &m_snr[aid * MAX_POSITIONS];
+  const int64_t* updated = &m_updated[aid * MAX_POSITIONS];
+  double sum = 0.0;
+  std::size_t count = 0;
+  for (std::size_t w = 0; w < ru.size (); w++)
+    {
+      for (uint64_t word = ru[w]; word != 0; word &= word - 1)
+        {
+          std::size_t p = w * 64 + __builtin_ctzll (word);
+          if (p < MAX_POSITIONS && updated[p] >= 0 && now - updated[p] <= m_maxAge)
+            {
+              sum += snr[p];
+              count++;
+            }
+        }
+    }
+  if (count == 0)
+    {
+      return false;
+    }
+  snrDb = sum / count;
+  return true;
+}
+
+} //namespace ns3
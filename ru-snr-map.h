@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RU_SNR_MAP_H
+#define RU_SNR_MAP_H
+
+#include "he-ru-tiling.h"
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * RuSnrMap keeps, for each associated station (identified by its AID), the
+ * SNR of the signal received from the station on each 26-tone RU position of
+ * the channel (see HeRuTiling). An HE TB PPDU updates the positions of the RU
+ * the station transmitted on, while a PPDU occupying the whole channel (e.g.,
+ * a Block Ack or a sounding frame) updates all the positions. Samples are
+ * averaged with an exponential moving average and discarded once they are
+ * older than the configured maximum age (roughly the coherence time of the
+ * channel), after which the position is unknown again.
+ */
+class RuSnrMap
+{
+public:
+  static const std::size_t MAX_POSITIONS = 74;   //!< 26-tone RU positions of a 160 MHz channel
+
+  RuSnrMap ();
+
+  /**
+   * \param alpha the weight of a new sample in the moving average (0 < alpha <= 1)
+   */
+  void SetAveraging (double alpha);
+  /**
+   * \param maxAge the age (ns) beyond which a sample is discarded
+   */
+  void SetMaxAge (int64_t maxAge);
+
+  /**
+   * Notify that a station has associated with the AP.
+   *
+   * \param aid the AID of the station
+   */
+  void NotifyAssociation (uint16_t aid);
+  /**
+   * Notify that a station has disassociated from the AP.
+   *
+   * \param aid the AID of the station
+   */
+  void NotifyDisassociation (uint16_t aid);
+  /**
+   * Notify the SNR of a PPDU received from a station.
+   *
+   * \param aid the AID of the station
+   * \param positions the 26-tone RU positions occupied by the PPDU
+   * \param snrDb the SNR in dB
+   * \param now the current time (ns)
+   */
+  void NotifySnr (uint16_t aid, const HeRuTiling::Mask& positions, double snrDb, int64_t now);
+
+  /**
+   * \param aid the AID of a station
+   * \param now the current time (ns)
+   * \param snrDb the SNR (dB) of the station on each of the MAX_POSITIONS
+   *        positions, NaN if unknown
+   * \return true if the SNR of the station is known on at least one position
+   */
+  bool GetSnr (uint16_t aid, int64_t now, float* snrDb) const;
+  /**
+   * \param aid the AID of a station
+   * \param ru the 26-tone RU positions covered by an RU
+   * \param now the current time (ns)
+   * \param snrDb the mean SNR (dB) of the station over the positions of the RU
+   *        whose SNR is known
+   * \return true if the SNR of the station is known on at least one position of the RU
+   */
+  bool GetRuSnr (uint16_t aid, const HeRuTiling::Mask& ru, int64_t now, double& snrDb) const;
+
+private:
+  /**
+   * Make room for the given AID.
+   *
+   * \param aid the AID
+   */
+  void Grow (uint16_t aid);
+
+  double m_alpha;                   //!< weight of a new sample
+  int64_t m_maxAge;                 //!< age (ns) beyond which a sample is discarded
+  std::vector<float> m_snr;         //!< averaged SNR (dB), MAX_POSITIONS per AID
+  std::vector<int64_t> m_updated;   //!< time (ns) of the last sample (-1 if none), MAX_POSITIONS per AID
+};
+
+} //namespace ns3
+
+#endif /* RU_SNR_MAP_H */
@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "scheduler-arena.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace ns3 {
+
+SchedulerArena::SchedulerArena (std::size_t blockSize)
+  : m_blockSize (blockSize),
+    m_block (0),
+    m_offset (0)
+{
+  NS_ASSERT (blockSize > 0);
+}
+
+void*
+SchedulerArena::Allocate (std::size_t bytes, std::size_t alignment)
+{
+  NS_ASSERT (alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+  while (true)
+    {
+      if (m_block < m_blocks.size ())
+        {
+          // align the address, not only the offset
+          uintptr_t base = reinterpret_cast<uintptr_t> (m_blocks[m_block].get ());
+          std::size_t offset = ((base + m_offset + alignment - 1) & ~(alignment - 1)) - base;
+          if (offset + bytes <= m_sizes[m_block])
+            {
+              m_offset = offset + bytes;
+              return m_blocks[m_block].get () + offset;
+            }
+          if (m_offset > 0 || m_block + 1 < m_blocks.size ())
+            {
+              // move to the next block, if any
+              m_block++;
+              m_offset = 0;
+              continue;
+            }
+        }
+      // no block is left (or the request does not fit an empty block): add
+      // one, large enough for the request
+      std::size_t size = std::max (m_blockSize, bytes + alignment);
+      m_blocks.insert (m_blocks.begin () + std::min (m_block, m_blocks.size ()),
+                       std::unique_ptr<char[]> (new char[size]));
+      m_sizes.insert (m_sizes.begin () + std::min (m_block, m_sizes.size ()), size);
+      m_block = std::min (m_block, m_blocks.size () - 1);
+      m_offset = 0;
+    }
+}
+
+void
+SchedulerArena::Reset (void)
+{
+  m_block = 0;
+  m_offset = 0;
+}
+
+std::size_t
+SchedulerArena::GetCapacity (void) const
+{
+  std::size_t capacity = 0;
+  for (auto size : m_sizes)
+    {
+      capacity += size;
+    }
+  return capacity;
+}
+
+} //namespace ns3
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SCHEDULER_ARENA_H
+#define SCHEDULER_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * SchedulerArena is a bump allocator for the scratch data of a scheduling
+ * cycle: memory is handed out by advancing an offset within large blocks and
+ * is never freed individually; Reset makes all the memory available again at
+ * the start of the next cycle. Blocks are kept across cycles, hence once the
+ * arena has grown to the largest cycle no memory is allocated from the heap.
+ * Containers use the arena through ArenaAllocator and must not be used after
+ * the arena is reset.
+ */
+class SchedulerArena
+{
+public:
+  /**
+   * \param blockSize the size in bytes of the blocks
+   */
+  explicit SchedulerArena (std::size_t blockSize = 16384);
+
+  /**
+   * \param bytes the number of bytes
+   * \param alignment the alignment (a power of two)
+   * \return a pointer to the allocated memory
+   */
+  void* Allocate (std::size_t bytes, std::size_t alignment);
+  /**
+   * Make all the memory of the arena available again.
+   */
+  void Reset (void);
+  /**
+   * \return the total size in bytes of the blocks of the arena
+   */
+  std::size_t GetCapacity (void) const;
+
+private:
+  SchedulerArena (const SchedulerArena&) = delete;
+  SchedulerArena& operator= (const SchedulerArena&) = delete;
+
+  std::size_t m_blockSize;                        //!< the size of the blocks
+  std::vector<std::unique_ptr<char[]>> m_blocks;  //!< the blocks
+  std::vector<std::size_t> m_sizes;               //!< the size of each block
+  std::size_t m_block;                            //!< the index of the current block
+  std::size_t m_offset;                           //!< the first free byte of the current block
+};
+
+/**
+ * \ingroup wifi
+ *
+ * Standard allocator handing out memory from a SchedulerArena, so that
+ * standard containers can hold the scratch data of a scheduling cycle.
+ * Deallocation does nothing: the memory is reclaimed when the arena is reset.
+ *
+ * \tparam T the type of the allocated objects
+ */
+template <class T>
+class ArenaAllocator
+{
+public:
+  typedef T value_type;   //!< the type of the allocated objects
+
+  /**
+   * \param arena the arena to allocate from
+   */
+  explicit ArenaAllocator (SchedulerArena& arena)
+    : m_arena (&arena)
+  {
+  }
+  /**
+   * \param other an allocator of another type
+   */
+  template <class U>
+  ArenaAllocator (const ArenaAllocator<U>& other)
+    : m_arena (other.GetArena ())
+  {
+  }
+
+  /**
+   * \param n the number of objects
+   * \return the memory for the given number of objects
+   */
+  T* allocate (std::size_t n)
+  {
+    return static_cast<T*> (m_arena->Allocate (n * sizeof (T), alignof (T)));
+  }
+  /**
+   * Do nothing: the memory is reclaimed when the arena is reset.
+   */
+  void deallocate (T* /* p */, std::size_t /* n */)
+  {
+  }
+  /**
+   * \return the arena
+   */
+  SchedulerArena* GetArena (void) const
+  {
+    return m_arena;
+  }
+
+private:
+  SchedulerArena* m_arena;   //!< the arena
+};
+
+/**
+ * \param a an allocator
+ * \param b another allocator
+ * \return true if the two allocators use the same arena
+ */
+template <class T, class U>
+bool
+operator== (const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+  return a.GetArena () == b.GetArena ();
+}
+
+/**
+ * \param a an allocator
+ * \param b another allocator
+ * \return true if the two allocators use different arenas
+ */
+template <class T, class U>
+bool
+operator!= (const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+  return a.GetArena () != b.GetArena ();
+}
+
+} //namespace ns3
+
+#endif /* SCHEDULER_ARENA_H */
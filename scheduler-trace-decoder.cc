@@ -0,0 +1,87 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "scheduler-trace.h"
+
+#include <cstdio>
+#include <cstring>
+#include <inttypes.h>
+
+using namespace ns3;
+
+/**
+ * \brief Decoder of the binary trace written by RrOfdmaManager
+ *
+ * Usage: g++ -O2 -std=c++11 scheduler-trace-decoder.cc -o scheduler-trace-decoder
+ *        ./scheduler-trace-decoder rr-ofdma-trace.bin > trace.txt
+ *
+ * Every record is printed on a line including the simulation time (ns), the
+ * record type (CAND for the weight of a candidate station, GRANT for the RU
+ * granted to a station), the AID, the weight and the MCS of the station and,
+ * for GRANT records, the number of tones and the index of the RU (followed by
+ * an S if the RU is in the secondary 80 MHz). Lines can be filtered, e.g.:
+ *
+ * grep GRANT trace.txt | awk '{print $3, $6}'    (AID and RU size of the grants)
+ */
+int
+main (int argc, char *argv[])
+{
+  if (argc != 2)
+    {
+      std::fprintf (stderr, "Usage: %s <trace file>\n", argv[0]);
+      return 1;
+    }
+
+  std::FILE* file = std::fopen (argv[1], "rb");
+  if (file == 0)
+    {
+      std::fprintf (stderr, "Cannot open %s\n", argv[1]);
+      return 1;
+    }
+
+  SchedulerTraceHeader header;
+  if (std::fread (&header, sizeof (header), 1, file) != 1
+      || std::strncmp (header.magic, "RROFDMA", sizeof (header.magic)) != 0)
+    {
+      std::fprintf (stderr, "%s is not a scheduler trace\n", argv[1]);
+      std::fclose (file);
+      return 1;
+    }
+  if (header.version != SchedulerTrace::VERSION || header.recordSize != sizeof (SchedulerTraceRecord))
+    {
+      std::fprintf (stderr, "Unsupported trace version %u (record size %u)\n", header.version, header.recordSize);
+      std::fclose (file);
+      return 1;
+    }
+
+  SchedulerTraceRecord record;
+  while (std::fread (&record, sizeof (record), 1, file) == 1)
+    {
+      if (record.level == SchedulerTrace::GRANTS)
+        {
+          std::printf ("%" PRId64 " GRANT %u %.6g %u %u %u%s\n", record.timestamp, record.aid, record.weight,
+                       record.mcs, record.ruTones, record.ruIndex, record.primary80MHz ? "" : "S");
+        }
+      else
+        {
+          std::printf ("%" PRId64 " CAND %u %.6g %u\n", record.timestamp, record.aid, record.weight,
+                       record.mcs);
+        }
+    }
+
+  std::fclose (file);
+  return 0;
+}
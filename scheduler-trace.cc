@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "scheduler-trace.h"
+#include <cstring>
+
+namespace ns3 {
+
+static_assert (sizeof (SchedulerTraceRecord) == 24, "Unexpected padding in the trace record");
+static_assert (sizeof (SchedulerTraceHeader) == 16, "Unexpected padding in the trace header");
+
+const uint32_t SchedulerTrace::VERSION;
+
+SchedulerTrace::SchedulerTrace ()
+  : m_level (NONE),
+    m_file (0),
+    m_stop (false)
+{
+}
+
+SchedulerTrace::~SchedulerTrace ()
+{
+  Close ();
+}
+
+void
+SchedulerTrace::Open (std::string filename, uint8_t level, std::size_t bufferSize)
+{
+  NS_ASSERT (bufferSize > 0);
+  Close ();
+
+  m_file = std::fopen (filename.c_str (), "wb");
+  NS_ABORT_MSG_IF (m_file == 0, "Cannot open the scheduler trace file " << filename);
+
+  SchedulerTraceHeader header;
+  std::memset (&header, 0, sizeof (header));
+  std::strncpy (header.magic, "RROFDMA", sizeof (header.magic));
+  header.version = VERSION;
+  header.recordSize = sizeof (SchedulerTraceRecord);
+  std::fwrite (&header, sizeof (header), 1, m_file);
+
+  m_buffer.clear ();
+  m_buffer.reserve (bufferSize);
+  m_pending.clear ();
+  m_pending.reserve (bufferSize);
+  m_stop = false;
+  m_writer = std::thread (&SchedulerTrace::WriterLoop, this);
+  m_level = level;
+}
+
+void
+SchedulerTrace::Close (void)
+{
+  if (m_file == 0)
+    {
+      return;
+    }
+  m_level = NONE;
+  Flush ();
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all ();
+  m_writer.join ();
+  std::fclose (m_file);
+  m_file = 0;
+}
+
+void
+SchedulerTrace::WriteCandidate (int64_t timestamp, uint16_t aid, double weight, uint8_t mcs)
+{
+  Append ({timestamp, weight, aid, 0, CANDIDATES, mcs, 0, 0});
+}
+
+void
+SchedulerTrace::WriteGrant (int64_t timestamp, uint16_t aid, double weight, uint8_t mcs,
+                            uint16_t ruTones, uint8_t ruIndex, bool primary80MHz)
+{
+  Append ({timestamp, weight, aid, ruTones, GRANTS, mcs, ruIndex, primary80MHz});
+}
+
+void
+SchedulerTrace::Append (const SchedulerTraceRecord& record)
+{
+  NS_ASSERT (m_file != 0);
+  m_buffer.push_back (record);
+  if (m_buffer.size () == m_buffer.capacity ())
+    {
+      Flush ();
+    }
+}
+
+void
+SchedulerTrace::Flush (void)
+{
+  if (m_buffer.empty ())
+    {
+      return;
+    }
+  {
+    // the writer thread clears the pending buffer once written
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_cv.wait (lock, [this] { return m_pending.empty (); });
+    m_buffer.swap (m_pending);
+  }
+  m_cv.notify_all ();
+}
+
+void
+SchedulerTrace::WriterLoop (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      m_cv.wait (lock, [this] { return !m_pending.empty () || m_stop; });
+      if (m_pending.empty ())
+        {
+          break;    // stopped and nothing left to write
+        }
+      // the producer does not touch the pending buffer until it is cleared
+      lock.unlock ();
+      std::fwrite (m_pending.data (), sizeof (SchedulerTraceRecord), m_pending.size (), m_file);
+      lock.lock ();
+      m_pending.clear ();
+      m_cv.notify_all ();
+    }
+}
+
+} //namespace ns3
@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SCHEDULER_TRACE_H
+#define SCHEDULER_TRACE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Highest trace level compiled in. Trace points above this level are removed
+ * by the compiler; define it to 0 to remove all of them.
+ */
+#ifndef SCHEDULER_TRACE_MAX_LEVEL
+#define SCHEDULER_TRACE_MAX_LEVEL 2
+#endif
+
+/**
+ * \param trace a SchedulerTrace
+ * \param level a trace level
+ * \return true if records of the given level are compiled in and enabled at run time
+ */
+#define SCHEDULER_TRACE_ENABLED(trace, level) \
+  ((level) <= SCHEDULER_TRACE_MAX_LEVEL && (trace).IsEnabled (level))
+
+namespace ns3 {
+
+/**
+ * A fixed-size binary record of SchedulerTrace (24 bytes, host byte order).
+ */
+struct SchedulerTraceRecord
+{
+  int64_t timestamp;        //!< simulation time (ns)
+  double weight;            //!< M-LWDF weight of the station
+  uint16_t aid;             //!< AID of the station
+  uint16_t ruTones;         //!< tones of the granted RU (0 if none)
+  uint8_t level;            //!< trace level (i.e., the record type)
+  uint8_t mcs;              //!< MCS of the station
+  uint8_t ruIndex;          //!< index of the granted RU
+  uint8_t primary80MHz;     //!< whether the granted RU is in the primary 80 MHz
+};
+
+/**
+ * Header at the beginning of a SchedulerTrace file.
+ */
+struct SchedulerTraceHeader
+{
+  char magic[8];            //!< "RROFDMA" followed by a null character
+  uint32_t version;         //!< version of the file format
+  uint32_t recordSize;      //!< size in bytes of a record
+};
+
+/**
+ * \ingroup wifi
+ *
+ * SchedulerTrace writes the decisions of the OFDMA scheduler to a file as
+ * fixed-size binary records (see scheduler-trace-decoder.cc to convert them
+ * to text). Records are appended to a preallocated memory buffer; when the
+ * buffer is full, it is swapped with a second buffer that a background thread
+ * writes to the file, so that the simulation only waits if the disk cannot
+ * keep up. Trace points are guarded by SCHEDULER_TRACE_ENABLED, which checks
+ * both the compile-time and the run-time level, hence a disabled trace point
+ * costs at most a comparison.
+ */
+class SchedulerTrace
+{
+public:
+  /// Trace levels
+  enum Level : uint8_t
+  {
+    NONE = 0,          //!< no records
+    GRANTS = 1,        //!< one record per station granted an RU
+    CANDIDATES = 2     //!< also one record per candidate station, with its weight
+  };
+
+  static const uint32_t VERSION = 1;    //!< version of the file format
+
+  SchedulerTrace ();
+  ~SchedulerTrace ();
+
+  /**
+   * Start writing records up to the given level to the given file.
+   *
+   * \param filename the name of the file
+   * \param level the highest level of the records to write
+   * \param bufferSize the number of records buffered before a write
+   */
+  void Open (std::string filename, uint8_t level, std::size_t bufferSize = 4096);
+  /**
+   * Write the buffered records and close the file.
+   */
+  void Close (void);
+
+  /**
+   * \param level a trace level
+   * \return true if records of the given level are written
+   */
+  bool IsEnabled (uint8_t level) const
+  {
+    return level <= m_level;
+  }
+
+  /**
+   * Record the weight of a candidate station (level CANDIDATES).
+   *
+   * \param timestamp the simulation time (ns)
+   * \param aid the AID of the station
+   * \param weight the weight of the station
+   * \param mcs the MCS of the station
+   */
+  void WriteCandidate (int64_t timestamp, uint16_t aid, double weight, uint8_t mcs);
+  /**
+   * Record the RU granted to a station (level GRANTS).
+   *
+   * \param timestamp the simulation time (ns)
+   * \param aid the AID of the station
+   * \param weight the weight of the station
+   * \param mcs the MCS of the station
+   * \param ruTones the tones of the RU
+   * \param ruIndex the index of the RU
+   * \param primary80MHz whether the RU is in the primary 80 MHz
+   */
+  void WriteGrant (int64_t timestamp, uint16_t aid, double weight, uint8_t mcs,
+                   uint16_t ruTones, uint8_t ruIndex, bool primary80MHz);
+
+private:
+  /**
+   * Append a record to the buffer, handing the buffer over to the writer
+   * thread if full.
+   *
+   * \param record the record
+   */
+  void Append (const SchedulerTraceRecord& record);
+  /**
+   * Wait for the writer thread to be idle and hand the buffer over to it.
+   */
+  void Flush (void);
+  /**
+   * Body of the writer thread.
+   */
+  void WriterLoop (void);
+
+  uint8_t m_level;                                   //!< highest level of the written records
+  std::FILE* m_file;                                 //!< the trace file
+  std::vector<SchedulerTraceRecord> m_buffer;        //!< records being appended
+  std::vector<SchedulerTraceRecord> m_pending;       //!< records being written by the writer thread
+  std::thread m_writer;                              //!< the writer thread
+  std::mutex m_mutex;                                //!< protects m_pending and m_stop
+  std::condition_variable m_cv;                      //!< signals a change of m_pending or m_stop
+  bool m_stop;                                       //!< whether the writer thread has to terminate
+};
+
+} //namespace ns3
+
+#endif /* SCHEDULER_TRACE_H */
@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "scheduling-policy.h"
+
+namespace ns3 {
+
+// -log(delta_i)/T_i of classes 1 (CBR), 2 (voice), 3 (web) and 4 (bulk)
+const StaStateTable::ClassCoefficients MlwdfPolicy::COEFFICIENT {{0, 10, 5.4927, 2.3299, 1.50515}};
+
+// a_i of the M-LWDF policy in Q16
+const std::array<uint64_t, TrafficClassifier::N_CLASSES + 1> FixedPointMlwdfPolicy::COEFFICIENT_Q16
+{{0, 655360, 359970, 152692, 98642}};
+const uint64_t FixedPointMlwdfPolicy::MAX_DELAY_US;
+const unsigned FixedPointMlwdfPolicy::WEIGHT_BITS;
+
+// delay bounds of classes 1 (CBR), 2 (voice), 3 (web) and 4 (bulk)
+const StaStateTable::ClassCoefficients EdfPolicy::DELAY_BOUND {{0, 0.05, 0.1, 0.3, 1.0}};
+const double EdfPolicy::MAX_DELAY_BOUND = 1.0;
+
+void
+FixedPointMlwdfPolicy::WeightAll (std::size_t n, const uint8_t* trafficClass, const uint8_t* mcs,
+                                  const double* holDelay, const double* avgThroughput,
+                                  const uint32_t* /* backlog */, const StaStateTable::McsRates& rate,
+                                  double* weight)
+{
+  m_weight.resize (n);
+  uint64_t largest = 0;
+  for (std::size_t i = 0; i < n; i++)
+    {
+      m_weight[i] = (trafficClass[i] != TrafficClassifier::UNKNOWN
+                     ? FixedWeight (trafficClass[i], holDelay[i], rate[mcs[i]], avgThroughput[i])
+                     : 0);
+      largest = std::max (largest, m_weight[i]);
+    }
+
+  unsigned shift = GetShift (largest);
+  for (std::size_t i = 0; i < n; i++)
+    {
+      weight[i] = (trafficClass[i] != TrafficClassifier::UNKNOWN
+                   ? static_cast<double> (Normalize (m_weight[i], shift))
+                   : 0.0);
+    }
+}
+
+void
+ExpPfPolicy::Prepare (const StaStateTable& table)
+{
+  double sum = 0;
+  std::size_t n = 0;
+  for (auto aid : table.GetCandidates ())
+    {
+      uint8_t trafficClass = table.GetClass (aid);
+      if (trafficClass != BULK_CLASS)
+        {
+          sum += MlwdfPolicy::COEFFICIENT[trafficClass] * table.GetHolDelay (aid);
+          n++;
+        }
+    }
+  m_meanDelay = (n > 0 ? sum / n : 0);
+  m_denominator = 1 + std::sqrt (m_meanDelay);
+}
+
+} //namespace ns3
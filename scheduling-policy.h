@@ -0,0 +1,325 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SCHEDULING_POLICY_H
+#define SCHEDULING_POLICY_H
+
+#include "mlwdf-weight-kernel.h"
+#include "sta-state-table.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * The scheduling policies that can be used to weight the candidate stations.
+ */
+enum SchedulingPolicyType
+{
+  MLWDF_POLICY = 0,
+  PF_POLICY,
+  EXP_PF_POLICY,
+  EDF_POLICY,
+  MAX_WEIGHT_POLICY
+};
+
+/**
+ * \ingroup wifi
+ *
+ * Base class of the scheduling policies (CRTP). A policy computes the weight
+ * of a candidate station from its traffic class, head-of-line delay, rate,
+ * served throughput and backlog; StaStateTable::ComputeWeights calls
+ * WeightAll, which calls Weight for every station in a loop that is
+ * instantiated for each policy, so that the call is inlined rather than
+ * dispatched at run time. Stations that are not candidates (unknown traffic
+ * class) have a null weight, whatever the policy. A policy can override
+ * Prepare to compute, before the loop, values that depend on all the
+ * candidates, and WeightAll to replace the loop itself, e.g., by a vectorized
+ * one.
+ *
+ * \tparam Policy the derived class, which provides
+ *         double DoWeight (uint8_t trafficClass, double holDelay, double rate,
+ *                          double avgThroughput, uint32_t backlog) const
+ */
+template <class Policy>
+class SchedulingPolicy
+{
+public:
+  /**
+   * Called by StaStateTable::ComputeWeights once the head-of-line delays have
+   * been computed and before the weights are computed.
+   *
+   * \param table the state of the stations
+   */
+  void Prepare (const StaStateTable& /* table */)
+  {
+  }
+  /**
+   * \param trafficClass the traffic class of the station
+   * \param holDelay the head-of-line delay (s) of the station
+   * \param rate the rate (Mb/s) of the MCS of the station
+   * \param avgThroughput the average throughput (Mb/s) served to the station
+   * \param backlog the bytes to send to the station
+   * \return the weight of the station
+   */
+  double Weight (uint8_t trafficClass, double holDelay, double rate, double avgThroughput,
+                 uint32_t backlog) const
+  {
+    return (trafficClass != TrafficClassifier::UNKNOWN
+            ? static_cast<const Policy*> (this)->DoWeight (trafficClass, holDelay, rate, avgThroughput, backlog)
+            : 0.0);
+  }
+  /**
+   * Compute the weight of a batch of stations by calling Weight for each of them.
+   *
+   * \param n the number of stations
+   * \param trafficClass the traffic class of each station
+   * \param mcs the MCS of each station
+   * \param holDelay the head-of-line delay (s) of each station
+   * \param avgThroughput the average throughput (Mb/s) served to each station
+   * \param backlog the bytes to send to each station
+   * \param rate the rate (Mb/s) of each MCS
+   * \param weight the computed weight of each station
+   */
+  void WeightAll (std::size_t n, const uint8_t* trafficClass, const uint8_t* mcs, const double* holDelay,
+                  const double* avgThroughput, const uint32_t* backlog, const StaStateTable::McsRates& rate,
+                  double* weight) const
+  {
+    for (std::size_t i = 0; i < n; i++)
+      {
+        weight[i] = Weight (trafficClass[i], holDelay[i], rate[mcs[i]], avgThroughput[i], backlog[i]);
+      }
+  }
+};
+
+/**
+ * \ingroup wifi
+ *
+ * Modified Largest Weighted Delay First: a_i * W_i * r_i / R_i, where a_i is
+ * -log(delta_i)/T_i for the traffic class of the station, W_i the head-of-line
+ * delay, r_i the rate and R_i the served throughput.
+ */
+class MlwdfPolicy : public SchedulingPolicy<MlwdfPolicy>
+{
+public:
+  /// coefficient a_i of each traffic class
+  static const StaStateTable::ClassCoefficients COEFFICIENT;
+
+  /// \copydoc SchedulingPolicy::Weight
+  double DoWeight (uint8_t trafficClass, double holDelay, double rate, double avgThroughput,
+                   uint32_t /* backlog */) const
+  {
+    return COEFFICIENT[trafficClass] * holDelay * rate / avgThroughput;
+  }
+  /// \copydoc SchedulingPolicy::WeightAll
+  void WeightAll (std::size_t n, const uint8_t* trafficClass, const uint8_t* mcs, const double* holDelay,
+                  const double* avgThroughput, const uint32_t* /* backlog */, const StaStateTable::McsRates& rate,
+                  double* weight) const
+  {
+    MlwdfWeightKernel::Compute (n, trafficClass, mcs, holDelay, avgThroughput, COEFFICIENT, rate, weight);
+  }
+};
+
+/**
+ * \ingroup wifi
+ *
+ * M-LWDF computed in fixed point: the coefficient a_i is a Q16 constant, the
+ * head-of-line delay is rounded to microseconds (capped at MAX_DELAY_US), the
+ * rate and the served throughput are rounded to kb/s and the weight
+ * ((a_i W_i) >> 8) r_i / R_i is computed with 64-bit integers. The weights of
+ * a decision then share a block exponent: they are shifted right until the
+ * largest one fits in WEIGHT_BITS bits (a candidate weighs at least 1), so
+ * that the products of weights and byte counts, and their sums, computed by
+ * RuPatternAllocator are exact in double precision. Equal weights are ranked
+ * by increasing AID (see MlwdfRanking).
+ *
+ * The weights are integers once the inputs are rounded, which absorbs most of
+ * the differences between builds, but the inputs themselves are floating-point
+ * values: W_i and r_i are passed as double and R_i is a moving average decayed
+ * with std::exp (see ServedThroughputTracker), hence an input close to a
+ * rounding boundary may still round differently with another compiler, other
+ * flags or another math library.
+ */
+class FixedPointMlwdfPolicy : public SchedulingPolicy<FixedPointMlwdfPolicy>
+{
+public:
+  /// coefficient a_i (Q16) of each traffic class
+  static const std::array<uint64_t, TrafficClassifier::N_CLASSES + 1> COEFFICIENT_Q16;
+  /// the largest head-of-line delay (us) accounted for
+  static const uint64_t MAX_DELAY_US = 1 << 24;
+  /// the number of bits of the normalized weights
+  static const unsigned WEIGHT_BITS = 26;
+
+  /**
+   * \param trafficClass the traffic class of the station
+   * \param holDelay the head-of-line delay (s) of the station
+   * \param rate the rate (Mb/s) of the MCS of the station, a multiple of 1 kb/s
+   * \param avgThroughput the average throughput (Mb/s) served to the station
+   * \return the weight of the station before normalization
+   */
+  static uint64_t FixedWeight (uint8_t trafficClass, double holDelay, double rate, double avgThroughput)
+  {
+    uint64_t delayUs = std::min (static_cast<uint64_t> (holDelay * 1e6 + 0.5), MAX_DELAY_US);
+    uint64_t rateKbps = static_cast<uint64_t> (rate * 1e3 + 0.5);
+    uint64_t avgKbps = std::max<uint64_t> (static_cast<uint64_t> (avgThroughput * 1e3), 1);
+    return ((COEFFICIENT_Q16[trafficClass] * delayUs) >> 8) * rateKbps / avgKbps;
+  }
+
+  /// \copydoc SchedulingPolicy::Weight
+  double DoWeight (uint8_t trafficClass, double holDelay, double rate, double avgThroughput,
+                   uint32_t /* backlog */) const
+  {
+    return static_cast<double> (FixedWeight (trafficClass, holDelay, rate, avgThroughput));
+  }
+  /**
+   * \param largest the largest weight of a decision before normalization
+   * \return the block exponent of the decision: the number of bits the weights
+   *         are shifted right by
+   */
+  static unsigned GetShift (uint64_t largest)
+  {
+    unsigned shift = 0;
+    while ((largest >> shift) >= (UINT64_C (1) << WEIGHT_BITS))
+      {
+        shift++;
+      }
+    return shift;
+  }
+  /**
+   * \param weight the weight of a candidate before normalization
+   * \param shift the block exponent of the decision
+   * \return the normalized weight of the candidate
+   */
+  static uint64_t Normalize (uint64_t weight, unsigned shift)
+  {
+    return std::max<uint64_t> (weight >> shift, 1);
+  }
+  /**
+   * Compute the weights of a batch of stations and normalize them.
+   *
+   * \copydetails SchedulingPolicy::WeightAll
+   */
+  void WeightAll (std::size_t n, const uint8_t* trafficClass, const uint8_t* mcs, const double* holDelay,
+                  const double* avgThroughput, const uint32_t* backlog, const StaStateTable::McsRates& rate,
+                  double* weight);
+
+private:
+  std::vector<uint64_t> m_weight;   //!< the weights before normalization
+};
+
+/**
+ * \ingroup wifi
+ *
+ * Proportional Fair: r_i / R_i, where r_i is the rate and R_i the served throughput.
+ */
+class PfPolicy : public SchedulingPolicy<PfPolicy>
+{
+public:
+  /// \copydoc SchedulingPolicy::Weight
+  double DoWeight (uint8_t /* trafficClass */, double /* holDelay */, double rate, double avgThroughput,
+                   uint32_t /* backlog */) const
+  {
+    return rate / avgThroughput;
+  }
+};
+
+/**
+ * \ingroup wifi
+ *
+ * Exponential/Proportional Fair: stations of the real-time classes (all but
+ * the bulk class) are weighted exp((a_i W_i - aW) / (1 + sqrt(aW))) * r_i / R_i,
+ * where aW is the mean of a_i W_i over the real-time candidates (a_i is the
+ * M-LWDF coefficient); stations of the bulk class are weighted r_i / R_i.
+ */
+class ExpPfPolicy : public SchedulingPolicy<ExpPfPolicy>
+{
+public:
+  /// the traffic class that is not real-time
+  static const uint8_t BULK_CLASS = TrafficClassifier::N_CLASSES;
+
+  ExpPfPolicy ()
+    : m_meanDelay (0),
+      m_denominator (1)
+  {
+  }
+
+  /// \copydoc SchedulingPolicy::Prepare
+  void Prepare (const StaStateTable& table);
+
+  /// \copydoc SchedulingPolicy::Weight
+  double DoWeight (uint8_t trafficClass, double holDelay, double rate, double avgThroughput,
+                   uint32_t /* backlog */) const
+  {
+    double pf = rate / avgThroughput;
+    if (trafficClass == BULK_CLASS)
+      {
+        return pf;
+      }
+    return std::exp ((MlwdfPolicy::COEFFICIENT[trafficClass] * holDelay - m_meanDelay) / m_denominator) * pf;
+  }
+
+private:
+  double m_meanDelay;       //!< mean of a_i W_i over the real-time candidates
+  double m_denominator;     //!< 1 + sqrt (m_meanDelay)
+};
+
+/**
+ * \ingroup wifi
+ *
+ * Earliest Deadline First: the deadline of the head-of-line frame is its
+ * enqueue time plus the delay bound of the traffic class of the station, hence
+ * the weight W_i + (T_max - T_i), where T_i is the delay bound and T_max the
+ * largest delay bound, grows as the deadline gets earlier and is positive.
+ */
+class EdfPolicy : public SchedulingPolicy<EdfPolicy>
+{
+public:
+  /// delay bound (s) of each traffic class
+  static const StaStateTable::ClassCoefficients DELAY_BOUND;
+  /// the largest delay bound (s)
+  static const double MAX_DELAY_BOUND;
+
+  /// \copydoc SchedulingPolicy::Weight
+  double DoWeight (uint8_t trafficClass, double holDelay, double /* rate */, double /* avgThroughput */,
+                   uint32_t /* backlog */) const
+  {
+    return holDelay + (MAX_DELAY_BOUND - DELAY_BOUND[trafficClass]);
+  }
+};
+
+/**
+ * \ingroup wifi
+ *
+ * Max-Weight: Q_i * r_i, where Q_i is the backlog (bytes) and r_i the rate.
+ */
+class MaxWeightPolicy : public SchedulingPolicy<MaxWeightPolicy>
+{
+public:
+  /// \copydoc SchedulingPolicy::Weight
+  double DoWeight (uint8_t /* trafficClass */, double /* holDelay */, double rate, double /* avgThroughput */,
+                   uint32_t backlog) const
+  {
+    return backlog * rate;
+  }
+};
+
+} //namespace ns3
+
+#endif /* SCHEDULING_POLICY_H */
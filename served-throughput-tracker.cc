@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "served-throughput-tracker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+ServedThroughputTracker::ServedThroughputTracker ()
+  : m_tau (0.1),
+    m_minThroughput (1e3)
+{
+}
+
+void
+ServedThroughputTracker::SetTimeConstant (Time timeConstant)
+{
+  NS_ASSERT (timeConstant.IsStrictlyPositive ());
+  m_tau = timeConstant.GetSeconds ();
+}
+
+void
+ServedThroughputTracker::SetMinThroughput (double bps)
+{
+  m_minThroughput = bps;
+}
+
+double
+ServedThroughputTracker::Decay (const Average& avg, double now) const
+{
+  if (now <= avg.lastUpdate)
+    {
+      return avg.bps;
+    }
+  return avg.bps * std::exp ((avg.lastUpdate - now) / m_tau);
+}
+
+void
+ServedThroughputTracker::NotifyServed (uint16_t aid, uint32_t bytes, Time now)
+{
+  double t = now.GetSeconds ();
+  double bits = bytes * 8.0;
+
+  if (aid >= m_sta.size ())
+    {
+      m_sta.resize (aid + 1);
+    }
+
+  Average& avg = m_sta[aid];
+  avg.bps = Decay (avg, t) + bits / m_tau;
+  avg.lastUpdate = t;
+}
+
+void
+ServedThroughputTracker::NotifyDisassociation (uint16_t aid)
+{
+  if (aid < m_sta.size ())
+    {
+      m_sta[aid] = Average ();
+    }
+}
+
+double
+ServedThroughputTracker::GetStaThroughput (uint16_t aid, Time now) const
+{
+  if (aid >= m_sta.size ())
+    {
+      return m_minThroughput;
+    }
+  return std::max (Decay (m_sta[aid], now.GetSeconds ()), m_minThroughput);
+}
+
+} //namespace ns3
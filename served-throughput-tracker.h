@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SERVED_THROUGHPUT_TRACKER_H
+#define SERVED_THROUGHPUT_TRACKER_H
+
+#include "ns3/nstime.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * ServedThroughputTracker keeps an exponentially weighted moving average of
+ * the throughput served to each station (identified by its AID). Every time
+ * some bytes are served, the current average is decayed by exp(-elapsed/tau)
+ * and the served bits, divided by tau, are added to it, where tau is the
+ * configured time constant. Both updating and reading an average take
+ * constant time.
+ */
+class ServedThroughputTracker
+{
+public:
+  ServedThroughputTracker ();
+
+  /**
+   * Set the time constant of the moving averages.
+   *
+   * \param timeConstant the time constant
+   */
+  void SetTimeConstant (Time timeConstant);
+  /**
+   * Set the value returned for stations that have not been served recently,
+   * so that the average throughput can be safely used as a denominator.
+   *
+   * \param bps the minimum throughput in bit/s
+   */
+  void SetMinThroughput (double bps);
+
+  /**
+   * Notify that the given amount of bytes has been served to the given station.
+   *
+   * \param aid the AID of the station
+   * \param bytes the amount of bytes
+   * \param now the current time
+   */
+  void NotifyServed (uint16_t aid, uint32_t bytes, Time now);
+  /**
+   * Notify that a station has disassociated from the AP, so that a station
+   * later associated with the same AID starts from a null average.
+   *
+   * \param aid the AID of the station
+   */
+  void NotifyDisassociation (uint16_t aid);
+
+  /**
+   * \param aid the AID of the station
+   * \param now the current time
+   * \return the average throughput (bit/s) served to the given station
+   */
+  double GetStaThroughput (uint16_t aid, Time now) const;
+
+private:
+  /// Exponentially weighted moving average of a throughput
+  struct Average
+  {
+    double bps {0.0};       //!< the average throughput (bit/s) at the time of the last update
+    double lastUpdate {0.0}; //!< the time (s) of the last update
+  };
+
+  /**
+   * \param avg a moving average
+   * \param now the current time (s)
+   * \return the value of the given moving average at the current time
+   */
+  double Decay (const Average& avg, double now) const;
+
+  double m_tau;                  //!< the time constant (s)
+  double m_minThroughput;        //!< the minimum returned throughput (bit/s)
+  std::vector<Average> m_sta;    //!< moving averages indexed by AID
+};
+
+} //namespace ns3
+
+#endif /* SERVED_THROUGHPUT_TRACKER_H */
@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "sta-state-table.h"
+#include <algorithm>
+
+namespace ns3 {
+
+StaStateTable::StaStateTable ()
+{
+}
+
+void
+StaStateTable::Grow (uint16_t aid)
+{
+  if (aid < m_address.size ())
+    {
+      return;
+    }
+  std::size_t size = aid + 1;
+  m_address.resize (size);
+  m_tid.resize (size, 0);
+  m_backlog.resize (size, 0);
+  m_class.resize (size, TrafficClassifier::UNKNOWN);
+  m_mcs.resize (size, 0);
+  m_weight.resize (size, 0.0);
+  // never used as a null denominator by stations that are not candidates
+  m_avgThroughput.resize (size, 1.0);
+  m_holTimestamp.resize (size, 0);
+  m_holDelay.resize (size, 0.0);
+  m_ru.resize (size, {true, HeRu::RU_26_TONE, 1});
+  m_hasRu.resize (size, 0);
+}
+
+void
+StaStateTable::NotifyAssociation (uint16_t aid, Mac48Address address)
+{
+  Grow (aid);
+  m_address[aid] = address;
+}
+
+void
+StaStateTable::NotifyDisassociation (uint16_t aid)
+{
+  if (aid < m_address.size ())
+    {
+      m_address[aid] = Mac48Address ();
+    }
+}
+
+void
+StaStateTable::ClearCandidates (void)
+{
+  for (auto aid : m_candidates)
+    {
+      m_backlog[aid] = 0;
+      m_class[aid] = TrafficClassifier::UNKNOWN;
+      m_weight[aid] = 0.0;
+    }
+  for (auto aid : m_allocated)
+    {
+      m_hasRu[aid] = 0;
+    }
+  m_candidates.clear ();
+  m_allocated.clear ();
+}
+
+void
+StaStateTable::AddCandidate (uint16_t aid, Mac48Address address, uint8_t tid, uint32_t bytes,
+                             uint8_t trafficClass, uint8_t mcs, int64_t holTimestamp, double avgThroughput)
+{
+  NS_ASSERT (bytes > 0 && avgThroughput > 0);
+  NS_ASSERT (trafficClass != TrafficClassifier::UNKNOWN && trafficClass <= TrafficClassifier::N_CLASSES);
+  NS_ASSERT (mcs < HeRateTable::N_MCS);
+  Grow (aid);
+  m_address[aid] = address;
+  m_tid[aid] = tid;
+  m_backlog[aid] = bytes;
+  m_class[aid] = trafficClass;
+  m_mcs[aid] = mcs;
+  m_holTimestamp[aid] = holTimestamp;
+  m_avgThroughput[aid] = avgThroughput;
+  m_candidates.push_back (aid);
+}
+
+void
+StaStateTable::ComputeHolDelays (int64_t now)
+{
+  const int64_t* holTimestamp = m_holTimestamp.data ();
+  double* holDelay = m_holDelay.data ();
+
+  for (std::size_t aid = 0; aid < m_holDelay.size (); aid++)
+    {
+      holDelay[aid] = GetHolDelay (now, holTimestamp[aid]);
+    }
+}
+
+void
+StaStateTable::SetRu (uint16_t aid, HeRu::RuSpec ru)
+{
+  NS_ASSERT (aid < m_ru.size () && m_hasRu[aid] == 0);
+  m_ru[aid] = ru;
+  m_hasRu[aid] = 1;
+  m_allocated.push_back (aid);
+}
+
+} //namespace ns3
@@ -0,0 +1,265 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef STA_STATE_TABLE_H
+#define STA_STATE_TABLE_H
+
+#include "ns3/mac48-address.h"
+#include "he-ru.h"
+#include "he-rate-table.h"
+#include "traffic-classifier.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * StaStateTable holds the scheduler state of the associated stations as a
+ * struct of arrays indexed by AID: one column for each of the backlog, the
+ * traffic class, the MCS, the scheduling weight, the average served
+ * throughput, the timestamp and the delay of the head-of-line frame and the
+ * last assigned RU. The table persists across scheduling passes and is updated
+ * in place: a pass resets the entries of the previous candidates, adds the new
+ * candidates and computes the weights of all the AIDs in a single loop over
+ * contiguous columns, instantiated for the scheduling policy (stations that
+ * are not candidates have no traffic class, hence a null weight). The lists of
+ * candidates and of stations granted an RU keep their capacity, so that no
+ * memory is allocated once the table has grown to the largest AID.
+ */
+class StaStateTable
+{
+public:
+  /// Parameter of each traffic class (index 0 is unused)
+  typedef std::array<double, TrafficClassifier::N_CLASSES + 1> ClassCoefficients;
+  /// Rate (Mb/s) of each MCS
+  typedef std::array<double, HeRateTable::N_MCS> McsRates;
+
+  StaStateTable ();
+
+  /**
+   * Notify that a station has associated with the AP.
+   *
+   * \param aid the AID of the station
+   * \param address the MAC address of the station
+   */
+  void NotifyAssociation (uint16_t aid, Mac48Address address);
+  /**
+   * Notify that a station has disassociated from the AP.
+   *
+   * \param aid the AID of the station
+   */
+  void NotifyDisassociation (uint16_t aid);
+
+  /**
+   * Start a new scheduling pass: reset the entries of the candidates and of
+   * the stations granted an RU in the previous pass.
+   */
+  void ClearCandidates (void);
+  /**
+   * Add a candidate station for the current scheduling pass.
+   *
+   * \param aid the AID of the station
+   * \param address the MAC address of the station
+   * \param tid the TID of the frames to send to the station
+   * \param bytes the bytes to send to the station
+   * \param trafficClass the traffic class of the station
+   * \param mcs the MCS selected by the rate manager for the station
+   * \param holTimestamp the time (ns) the head-of-line frame was enqueued
+   * \param avgThroughput the average throughput (Mb/s) served to the station
+   */
+  void AddCandidate (uint16_t aid, Mac48Address address, uint8_t tid, uint32_t bytes,
+                     uint8_t trafficClass, uint8_t mcs, int64_t holTimestamp, double avgThroughput);
+  /**
+   * Compute the head-of-line delay of every station (see GetHolDelay).
+   *
+   * \param now the current time (ns)
+   */
+  void ComputeHolDelays (int64_t now);
+  /**
+   * A frame enqueued at the current time is deemed to have waited one
+   * nanosecond, so that the delay of a candidate is never null.
+   *
+   * \param now the current time (ns)
+   * \param holTimestamp the time (ns) the head-of-line frame was enqueued
+   * \return the head-of-line delay (s)
+   */
+  static double GetHolDelay (int64_t now, int64_t holTimestamp)
+  {
+    return std::max (static_cast<double> (now - holTimestamp), 1.0) * 1e-9;
+  }
+  /**
+   * Compute the head-of-line delay of every station and then the weight of
+   * every station according to the given policy (see SchedulingPolicy), given
+   * the rate of the MCS of the station.
+   *
+   * \tparam Policy the scheduling policy
+   * \param policy the scheduling policy
+   * \param rate the rate (Mb/s) of each MCS
+   * \param now the current time (ns)
+   */
+  template <class Policy>
+  void ComputeWeights (Policy& policy, const McsRates& rate, int64_t now);
+  /**
+   * Record the RU granted to a candidate station in the current pass.
+   *
+   * \param aid the AID of the station
+   * \param ru the RU
+   */
+  void SetRu (uint16_t aid, HeRu::RuSpec ru);
+
+  /**
+   * \return the AIDs of the candidate stations, in the order they were added
+   */
+  const std::vector<uint16_t>& GetCandidates (void) const
+  {
+    return m_candidates;
+  }
+  /**
+   * \return the AIDs of the stations granted an RU, in the order the RUs were set
+   */
+  const std::vector<uint16_t>& GetAllocated (void) const
+  {
+    return m_allocated;
+  }
+  /**
+   * \return the scheduling weight of each station, indexed by AID
+   */
+  const std::vector<double>& GetWeights (void) const
+  {
+    return m_weight;
+  }
+  /**
+   * \param aid the AID of a station
+   * \return the scheduling weight of the station, or zero if the AID is not in the table
+   */
+  double GetWeight (uint16_t aid) const
+  {
+    return aid < m_weight.size () ? m_weight[aid] : 0.0;
+  }
+
+  /**
+   * \param aid the AID of a station
+   * \return the MAC address of the station
+   */
+  Mac48Address GetAddress (uint16_t aid) const
+  {
+    return m_address[aid];
+  }
+  /**
+   * \param aid the AID of a candidate station
+   * \return the TID of the frames to send to the station
+   */
+  uint8_t GetTid (uint16_t aid) const
+  {
+    return m_tid[aid];
+  }
+  /**
+   * \param aid the AID of a candidate station
+   * \return the bytes to send to the station
+   */
+  uint32_t GetBacklog (uint16_t aid) const
+  {
+    return m_backlog[aid];
+  }
+  /**
+   * \param aid the AID of a candidate station
+   * \return the traffic class of the station
+   */
+  uint8_t GetClass (uint16_t aid) const
+  {
+    return m_class[aid];
+  }
+  /**
+   * \param aid the AID of a candidate station
+   * \return the MCS of the station
+   */
+  uint8_t GetMcs (uint16_t aid) const
+  {
+    return m_mcs[aid];
+  }
+  /**
+   * \param aid the AID of a candidate station
+   * \return the time (ns) the head-of-line frame was enqueued
+   */
+  int64_t GetHolTimestamp (uint16_t aid) const
+  {
+    return m_holTimestamp[aid];
+  }
+  /**
+   * \param aid the AID of a candidate station
+   * \return the head-of-line delay (s) computed by the last call to ComputeWeights
+   */
+  double GetHolDelay (uint16_t aid) const
+  {
+    return m_holDelay[aid];
+  }
+  /**
+   * \param aid the AID of a station
+   * \return true if the station was granted an RU in the current pass
+   */
+  bool HasRu (uint16_t aid) const
+  {
+    return aid < m_hasRu.size () && m_hasRu[aid] != 0;
+  }
+  /**
+   * \param aid the AID of a station
+   * \return the last RU granted to the station
+   */
+  const HeRu::RuSpec& GetRu (uint16_t aid) const
+  {
+    return m_ru[aid];
+  }
+
+private:
+  /**
+   * Make room for the given AID in all the columns.
+   *
+   * \param aid the AID
+   */
+  void Grow (uint16_t aid);
+
+  std::vector<Mac48Address> m_address;     //!< MAC address
+  std::vector<uint8_t> m_tid;              //!< TID of the frames to send
+  std::vector<uint32_t> m_backlog;         //!< bytes to send (zero if not a candidate)
+  std::vector<uint8_t> m_class;            //!< traffic class
+  std::vector<uint8_t> m_mcs;              //!< MCS selected by the rate manager
+  std::vector<double> m_weight;            //!< scheduling weight
+  std::vector<double> m_avgThroughput;     //!< average served throughput (Mb/s)
+  std::vector<int64_t> m_holTimestamp;     //!< enqueue time (ns) of the head-of-line frame
+  std::vector<double> m_holDelay;          //!< head-of-line delay (s)
+  std::vector<HeRu::RuSpec> m_ru;          //!< last granted RU
+  std::vector<uint8_t> m_hasRu;            //!< whether an RU was granted in the current pass
+  std::vector<uint16_t> m_candidates;      //!< AIDs of the candidates of the current pass
+  std::vector<uint16_t> m_allocated;       //!< AIDs of the stations granted an RU in the current pass
+};
+
+template <class Policy>
+void
+StaStateTable::ComputeWeights (Policy& policy, const McsRates& rate, int64_t now)
+{
+  ComputeHolDelays (now);
+  policy.Prepare (*this);
+
+  policy.WeightAll (m_weight.size (), m_class.data (), m_mcs.data (), m_holDelay.data (),
+                    m_avgThroughput.data (), m_backlog.data (), rate, m_weight.data ());
+}
+
+} //namespace ns3
+
+#endif /* STA_STATE_TABLE_H */
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "traffic-classifier.h"
+#include <fstream>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TrafficClassifier");
+
+const uint8_t TrafficClassifier::UNKNOWN;
+const uint8_t TrafficClassifier::N_CLASSES;
+
+TrafficClassifier::TrafficClassifier ()
+  // TIDs 0 and 3 (AC_BE): web, 1 and 2 (AC_BK): bulk, 4 and 5 (AC_VI): CBR, 6 and 7 (AC_VO): voice
+  : m_tidClass {{3, 4, 4, 3, 1, 1, 2, 2}}
+{
+}
+
+void
+TrafficClassifier::SetStationClass (Mac48Address address, uint8_t trafficClass)
+{
+  NS_LOG_FUNCTION (this << address << +trafficClass);
+  NS_ABORT_MSG_IF (trafficClass == UNKNOWN || trafficClass > N_CLASSES, "Invalid traffic class " << +trafficClass);
+
+  m_stationClass[address] = trafficClass;
+
+  // the station may be already associated
+  for (std::size_t aid = 0; aid < m_aidAddress.size (); aid++)
+    {
+      if (m_aidAddress[aid] == address)
+        {
+          m_aidClass[aid] = trafficClass;
+        }
+    }
+}
+
+void
+TrafficClassifier::SetTidClass (uint8_t tid, uint8_t trafficClass)
+{
+  NS_LOG_FUNCTION (this << +tid << +trafficClass);
+  NS_ABORT_MSG_IF (tid > 7, "Invalid TID " << +tid);
+  NS_ABORT_MSG_IF (trafficClass == UNKNOWN || trafficClass > N_CLASSES, "Invalid traffic class " << +trafficClass);
+  m_tidClass[tid] = trafficClass;
+}
+
+void
+TrafficClassifier::Load (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+
+  std::ifstream file (filename);
+  NS_ABORT_MSG_IF (!file.is_open (), "Cannot open the traffic class file " << filename);
+
+  std::string line;
+  for (uint32_t lineNo = 1; std::getline (file, line); lineNo++)
+    {
+      std::istringstream iss (line);
+      std::string address;
+      int trafficClass;
+      if (!(iss >> address) || address[0] == '#')
+        {
+          continue;
+        }
+      NS_ABORT_MSG_IF (!(iss >> trafficClass), filename << ":" << lineNo << ": missing traffic class");
+      NS_ABORT_MSG_IF (trafficClass <= UNKNOWN || trafficClass > N_CLASSES,
+                       filename << ":" << lineNo << ": invalid traffic class " << trafficClass);
+      SetStationClass (Mac48Address (address.c_str ()), static_cast<uint8_t> (trafficClass));
+    }
+}
+
+void
+TrafficClassifier::NotifyAssociation (uint16_t aid, Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << aid << address);
+
+  if (aid >= m_aidClass.size ())
+    {
+      m_aidClass.resize (aid + 1, UNKNOWN);
+      m_aidAddress.resize (aid + 1);
+    }
+
+  auto it = m_stationClass.find (address);
+  m_aidClass[aid] = (it != m_stationClass.end () ? it->second : UNKNOWN);
+  m_aidAddress[aid] = address;
+}
+
+void
+TrafficClassifier::NotifyDisassociation (uint16_t aid)
+{
+  NS_LOG_FUNCTION (this << aid);
+
+  if (aid < m_aidClass.size ())
+    {
+      m_aidClass[aid] = UNKNOWN;
+      m_aidAddress[aid] = Mac48Address ();
+    }
+}
+
+} //namespace ns3
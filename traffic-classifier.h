@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRAFFIC_CLASSIFIER_H
+#define TRAFFIC_CLASSIFIER_H
+
+#include "ns3/mac48-address.h"
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * TrafficClassifier maps each associated station to its M-LWDF traffic class
+ * (1: CBR, 2: voice, 3: web, 4: bulk). The class of a station can be set
+ * explicitly (e.g., by whoever installs the applications) or read from a
+ * configuration file; otherwise, it is derived from the TID of the frame to
+ * send (the TID is in turn derived from the DSCP of the packet by the upper
+ * layers). The class of the associated stations is kept in an array indexed
+ * by AID, which is filled upon association, so that a lookup takes constant
+ * time whatever the number of stations.
+ */
+class TrafficClassifier
+{
+public:
+  static const uint8_t UNKNOWN = 0;     //!< no class configured
+  static const uint8_t N_CLASSES = 4;   //!< classes are numbered from 1 to N_CLASSES
+
+  TrafficClassifier ();
+
+  /**
+   * Set the traffic class of the given station.
+   *
+   * \param address the MAC address of the station
+   * \param trafficClass the traffic class (1 to N_CLASSES)
+   */
+  void SetStationClass (Mac48Address address, uint8_t trafficClass);
+  /**
+   * Set the traffic class of the stations without a configured class that
+   * have frames of the given TID to receive.
+   *
+   * \param tid the TID
+   * \param trafficClass the traffic class (1 to N_CLASSES)
+   */
+  void SetTidClass (uint8_t tid, uint8_t trafficClass);
+  /**
+   * Read the traffic class of stations from the given file. Every line includes
+   * a MAC address and a traffic class separated by spaces; empty lines and
+   * lines starting with '#' are ignored.
+   *
+   * \param filename the name of the file
+   */
+  void Load (std::string filename);
+
+  /**
+   * Notify that a station has associated with the AP.
+   *
+   * \param aid the AID of the station
+   * \param address the MAC address of the station
+   */
+  void NotifyAssociation (uint16_t aid, Mac48Address address);
+  /**
+   * Notify that a station has disassociated from the AP.
+   *
+   * \param aid the AID of the station
+   */
+  void NotifyDisassociation (uint16_t aid);
+
+  /**
+   * \param aid the AID of an associated station
+   * \param tid the TID of the frame to send to the station
+   * \return the traffic class of the station
+   */
+  uint8_t GetClass (uint16_t aid, uint8_t tid) const
+  {
+    uint8_t trafficClass = (aid < m_aidClass.size () ? m_aidClass[aid] : UNKNOWN);
+    return (trafficClass != UNKNOWN ? trafficClass : m_tidClass[tid & 0x07]);
+  }
+
+private:
+  std::map<Mac48Address, uint8_t> m_stationClass;   //!< class configured for each station
+  std::vector<uint8_t> m_aidClass;                  //!< class of the associated stations, indexed by AID
+  std::vector<Mac48Address> m_aidAddress;           //!< address of the associated stations, indexed by AID
+  std::array<uint8_t, 8> m_tidClass;                //!< class of the stations without a configured class
+};
+
+} //namespace ns3
+
+#endif /* TRAFFIC_CLASSIFIER_H */
@@ -43,6 +43,8 @@
 #include "ns3/multi-model-spectrum-channel.h"
 #include "ns3/wifi-mac-queue.h"
 #include "ns3/mac-low.h"
+#include "ns3/rr-ofdma-manager.h"
+#include "ns3/frequency-selective-fading-model.h"
 #include "ns3/wifi-psdu.h"
 #include "ns3/ctrl-headers.h"
 #include "ns3/traffic-control-helper.h"
@@ -104,6 +106,13 @@ public:
    * Make the AP establish a BA agreement with the current station.
    */
   void EstablishBaAgreement (Mac48Address bssid);
+  /**
+   * Tell the DL OFDMA scheduler of the AP the traffic class of the given station.
+   *
+   * \param staIndex the index of the station
+   * \param trafficClass the M-LWDF traffic class
+   */
+  void SetTrafficClass (uint16_t staIndex, uint8_t trafficClass);
   /**
    * Start a client application.
    */
@@ -174,7 +183,13 @@ private:
   uint16_t m_channelCenterFrequency;
   uint16_t m_guardInterval; // GI in nanoseconds
   uint8_t m_maxNRus;        // max number of RUs per MU PPDU
+  bool m_adaptiveNRus;      // retune the max number of RUs online
+  bool m_fading;            // frequency-selective fading on the channel
+  bool m_snrPlacement;      // place the RUs where the stations have the best SNR
+  bool m_ruPower;           // allocate the power per RU
   uint32_t m_mcs;           // MCS value
+  std::string m_rateManager; // remote station manager type
+  std::string m_policy;     // scheduling policy
   uint16_t m_maxAmsduSize;  // maximum A-MSDU size
   uint32_t m_maxAmpduSize;  // maximum A-MSDU size
   double m_txopLimit;       // microseconds
@@ -269,7 +284,13 @@ WifiDlOfdmaExample::WifiDlOfdmaExample ()
     m_channelCenterFrequency (0),
     m_guardInterval (3200),
     m_maxNRus (9),
+    m_adaptiveNRus (false),
+    m_fading (false),
+    m_snrPlacement (false),
+    m_ruPower (false),
     m_mcs (10),
+    m_rateManager ("ns3::ConstantRateWifiManager"),
+    m_policy ("MLWDF"),
     m_maxAmsduSize (7500),
     m_maxAmpduSize (8388607u),
     m_txopLimit (10016),
@@ -328,7 +349,15 @@ WifiDlOfdmaExample::Config (int argc, char *argv[])
   cmd.AddValue ("channelWidth", "Channel bandwidth (20, 40, 80, 160)", m_channelWidth);
   cmd.AddValue ("guardInterval", "Guard Interval (800, 1600, 3200)", m_guardInterval);
   cmd.AddValue ("maxRus", "Maximum number of RUs allocated per DL MU PPDU", m_maxNRus);
+  cmd.AddValue ("adaptiveRus", "Retune online the maximum number of RUs, starting from maxRus", m_adaptiveNRus);
+  cmd.AddValue ("fading", "Apply frequency-selective Rayleigh block fading to the channel", m_fading);
+  cmd.AddValue ("snrPlacement", "Place the RUs where the stations have the best SNR", m_snrPlacement);
+  cmd.AddValue ("ruPower", "Compute the power offset of each RU by weighted water-filling and record it "
+                "in the decision log (the PHY transmits with a uniform PSD, the MCSs are unchanged)", m_ruPower);
   cmd.AddValue ("mcs", "The constant MCS value to transmit HE PPDUs", m_mcs);
+  cmd.AddValue ("rateManager", "Remote station manager (e.g., ns3::IdealWifiManager); "
+                "the mcs value is only used by ns3::ConstantRateWifiManager", m_rateManager);
+  cmd.AddValue ("policy", "Scheduling policy (MLWDF, PF, EXP_PF, EDF, MAX_WEIGHT)", m_policy);
   cmd.AddValue ("maxAmsduSize", "Maximum A-MSDU size", m_maxAmsduSize);
   cmd.AddValue ("maxAmpduSize", "Maximum A-MPDU size", m_maxAmpduSize);
   cmd.AddValue ("txopLimit", "TXOP duration in microseconds", m_txopLimit);
@@ -389,6 +418,8 @@ WifiDlOfdmaExample::Config (int argc, char *argv[])
     }
 
   std::cout << "Channel bw = " << m_channelWidth << " MHz" << std::endl
+            << "Rate manager = " << m_rateManager << std::endl
+            << "Scheduling policy = " << m_policy << std::endl
             << "MCS = " << m_mcs << std::endl
             << "Number of stations = " << m_nStations << std::endl
             << "Data rate = " << m_dataRate << " Mbps" << std::endl
@@ -419,6 +450,7 @@ WifiDlOfdmaExample::Setup (void)
   Config::SetDefault ("ns3::WifiMacQueue::MaxQueueSize", QueueSizeValue (QueueSize (PACKETS, m_macQueueSize)));
   Config::SetDefault ("ns3::WifiMacQueue::MaxDelay", TimeValue (MilliSeconds (m_msduLifetime)));
   Config::SetDefault ("ns3::HeConfiguration::MpduBufferSize", UintegerValue (m_baBufferSize));
+  Config::SetDefault ("ns3::RrOfdmaManager::RuPowerAllocation", BooleanValue (m_ruPower));
 
   m_staNodes.Create (m_nStations);
   m_apNodes.Create (1);
@@ -426,6 +458,11 @@ WifiDlOfdmaExample::Setup (void)
   Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel> ();
   Ptr<FriisPropagationLossModel> lossModel = CreateObject<FriisPropagationLossModel> ();
   spectrumChannel->AddPropagationLossModel (lossModel);
+  if (m_fading)
+    {
+      Ptr<FrequencySelectiveFadingModel> fadingModel = CreateObject<FrequencySelectiveFadingModel> ();
+      spectrumChannel->AddSpectrumPropagationLossModel (fadingModel);
+    }
   Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel> ();
   spectrumChannel->SetPropagationDelayModel (delayModel);
   SpectrumWifiPhyHelper phy = SpectrumWifiPhyHelper::Default ();
@@ -440,11 +477,20 @@ WifiDlOfdmaExample::Setup (void)
       wifi.EnableLogComponents ();
     }
   wifi.SetStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
-  std::ostringstream oss;
-  oss << "HeMcs" << m_mcs;
-  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
-                                "DataMode", StringValue (oss.str ()),
-                                "ControlMode", StringValue (oss.str ()));
+  if (m_rateManager == "ns3::ConstantRateWifiManager")
+    {
+      std::ostringstream oss;
+      oss << "HeMcs" << m_mcs;
+      wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                    "DataMode", StringValue (oss.str ()),
+                                    "ControlMode", StringValue (oss.str ()));
+    }
+  else
+    {
+      // the MCS of each station is selected by the rate manager and
+      // used by the OFDMA scheduler to size its RU
+      wifi.SetRemoteStationManager (m_rateManager);
+    }
   switch (m_dlAckSeqType)
     {
     case 1:
@@ -468,9 +514,12 @@ WifiDlOfdmaExample::Setup (void)
     {
       mac.SetOfdmaManager ("ns3::RrOfdmaManager",
                            "NStations", UintegerValue (m_maxNRus),
+                           "AdaptiveNStations", BooleanValue (m_adaptiveNRus),
+                           "SnrAwarePlacement", BooleanValue (m_snrPlacement),
                            "ForceDlOfdma", BooleanValue (m_forceDlOfdma),
                            "EnableUlOfdma", BooleanValue (m_enableUlOfdma),
-                           "UlPsduSize", UintegerValue (m_ulPsduSize));
+                           "UlPsduSize", UintegerValue (m_ulPsduSize),
+                           "Policy", StringValue (m_policy));
     }
 
   mac.SetType ("ns3::StaWifiMac",
@@ -756,6 +805,19 @@ WifiDlOfdmaExample::StartAssociation (void)
   dev->GetMac ()->SetSsid (m_ssid); // this will lead the station to associate with the AP
 }
 
+void
+WifiDlOfdmaExample::SetTrafficClass (uint16_t staIndex, uint8_t trafficClass)
+{
+  Ptr<WifiNetDevice> apDev = DynamicCast<WifiNetDevice> (m_apDevices.Get (0));
+  Ptr<RrOfdmaManager> scheduler = apDev->GetMac ()->GetObject<RrOfdmaManager> ();
+  if (scheduler == 0)
+    {
+      return;   // DL OFDMA is disabled
+    }
+  Ptr<WifiNetDevice> staDev = DynamicCast<WifiNetDevice> (m_staDevices.Get (staIndex));
+  scheduler->SetStationClass (staDev->GetMac ()->GetAddress (), trafficClass);
+}
+
 void
 WifiDlOfdmaExample::EstablishBaAgreement (Mac48Address bssid)
 {
@@ -790,6 +852,11 @@ WifiDlOfdmaExample::EstablishBaAgreement (Mac48Address bssid)
   std::string socketType_ONOFF= "ns3::UdpSocketFactory";
   
   uint16_t n = 4;
+  // tell the scheduler the M-LWDF class of the application installed below:
+  // CBR (1), bulk (4), web (3) or voice (2)
+  static const uint8_t trafficClass[] = {1, 4, 3, 2};
+  SetTrafficClass (m_currentSta, trafficClass[m_currentSta % n]);
+
   //uint16_t temp=;
   if(m_currentSta%n==0)
   {
@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ul-buffer-status.h"
+#include <algorithm>
+
+namespace ns3 {
+
+UlBufferStatus::UlBufferStatus ()
+{
+}
+
+void
+UlBufferStatus::Grow (uint16_t aid)
+{
+  if (aid < m_bytes.size ())
+    {
+      return;
+    }
+  std::size_t size = aid + 1;
+  m_bytes.resize (size, 0);
+  m_tid.resize (size, 0);
+  m_known.resize (size, 0);
+  m_waitingSince.resize (size, 0);
+}
+
+void
+UlBufferStatus::NotifyAssociation (uint16_t aid, int64_t now)
+{
+  Grow (aid);
+  m_bytes[aid] = 0;
+  m_known[aid] = 0;
+  m_waitingSince[aid] = now;
+}
+
+void
+UlBufferStatus::NotifyDisassociation (uint16_t aid)
+{
+  if (aid < m_bytes.size ())
+    {
+      m_bytes[aid] = 0;
+      m_known[aid] = 0;
+    }
+}
+
+void
+UlBufferStatus::NotifyQueueSize (uint16_t aid, uint8_t tid, uint8_t queueSize, int64_t now)
+{
+  Grow (aid);
+  if (queueSize == QUEUE_SIZE_UNKNOWN)
+    {
+      return;
+    }
+  uint32_t bytes = queueSize * QUEUE_SIZE_UNIT;
+  if (bytes > 0 && (m_known[aid] == 0 || m_bytes[aid] == 0))
+    {
+      // the station starts waiting
+      m_waitingSince[aid] = now;
+    }
+  m_bytes[aid] = bytes;
+  m_tid[aid] = tid;
+  m_known[aid] = 1;
+}
+
+void
+UlBufferStatus::NotifyReceived (uint16_t aid, uint32_t bytes, int64_t now)
+{
+  Grow (aid);
+  m_bytes[aid] -= std::min (m_bytes[aid], bytes);
+  m_waitingSince[aid] = now;
+}
+
+} //namespace ns3
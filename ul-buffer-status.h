@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef UL_BUFFER_STATUS_H
+#define UL_BUFFER_STATUS_H
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * UlBufferStatus keeps an estimate of the bytes buffered by each associated
+ * station (identified by its AID) for transmission to the AP. The estimate is
+ * set by the Queue Size reported in the QoS Control field of the QoS Data
+ * frames sent by the station (in 256-byte units; 254 means more than
+ * 254 x 256 bytes, which is taken as a lower bound, and 255 an unknown size)
+ * and decreased by the bytes received from the station in the meantime, e.g.,
+ * in HE TB PPDUs. The time since which the station has been waiting to be
+ * served (the time its buffer was reported non-empty, or it was last served,
+ * whichever is later) is kept as well, so that the stations can be weighted
+ * like in the downlink. Stations whose buffer status has never been reported
+ * have an unknown buffer status.
+ */
+class UlBufferStatus
+{
+public:
+  static const uint8_t QUEUE_SIZE_OVERFLOW = 254;   //!< the queue holds more than 254 units
+  static const uint8_t QUEUE_SIZE_UNKNOWN = 255;    //!< the queue size is not reported
+  static const uint32_t QUEUE_SIZE_UNIT = 256;      //!< bytes per unit of the Queue Size subfield
+
+  UlBufferStatus ();
+
+  /**
+   * Notify that a station has associated with the AP.
+   *
+   * \param aid the AID of the station
+   * \param now the current time (ns)
+   */
+  void NotifyAssociation (uint16_t aid, int64_t now);
+  /**
+   * Notify that a station has disassociated from the AP.
+   *
+   * \param aid the AID of the station
+   */
+  void NotifyDisassociation (uint16_t aid);
+
+  /**
+   * Notify that a station reported the size of one of its queues.
+   *
+   * \param aid the AID of the station
+   * \param tid the TID of the queue
+   * \param queueSize the value of the Queue Size subfield
+   * \param now the current time (ns)
+   */
+  void NotifyQueueSize (uint16_t aid, uint8_t tid, uint8_t queueSize, int64_t now);
+  /**
+   * Notify that bytes have been received from a station.
+   *
+   * \param aid the AID of the station
+   * \param bytes the received bytes
+   * \param now the current time (ns)
+   */
+  void NotifyReceived (uint16_t aid, uint32_t bytes, int64_t now);
+
+  /**
+   * \param aid the AID of a station
+   * \return true if the buffer status of the station has been reported
+   */
+  bool IsKnown (uint16_t aid) const
+  {
+    return aid < m_known.size () && m_known[aid] != 0;
+  }
+  /**
+   * \param aid the AID of a station whose buffer status is known
+   * \return the estimated bytes buffered by the station
+   */
+  uint32_t GetBytes (uint16_t aid) const
+  {
+    return m_bytes[aid];
+  }
+  /**
+   * \param aid the AID of a station whose buffer status is known
+   * \return the TID of the last reported queue
+   */
+  uint8_t GetTid (uint16_t aid) const
+  {
+    return m_tid[aid];
+  }
+  /**
+   * \param aid the AID of an associated station
+   * \return the time (ns) since which the station has been waiting to be served
+   */
+  int64_t GetWaitingSince (uint16_t aid) const
+  {
+    return m_waitingSince[aid];
+  }
+
+private:
+  /**
+   * Make room for the given AID.
+   *
+   * \param aid the AID
+   */
+  void Grow (uint16_t aid);
+
+  std::vector<uint32_t> m_bytes;          //!< estimated buffered bytes
+  std::vector<uint8_t> m_tid;             //!< TID of the last reported queue
+  std::vector<uint8_t> m_known;           //!< whether the buffer status has been reported
+  std::vector<int64_t> m_waitingSince;    //!< time (ns) since which the station is waiting
+};
+
+} //namespace ns3
+
+#endif /* UL_BUFFER_STATUS_H */